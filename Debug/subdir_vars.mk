@@ -12,13 +12,22 @@ C_SRCS += \
 ../ClawGame.c \
 ../adc.c \
 ../clocks.c \
+../dma.c \
+../dropPhysics.c \
+../joystickCal.c \
+../joystickFilter.c \
+../joystickMap.c \
 ../lcd.c \
+../lcdFormat.c \
 ../led.c \
+../motionQueue.c \
+../photoSensor.c \
 ../servoDriver.c \
+../snapshot.c \
 ../startup_msp432p4111_ccs.c \
 ../stateMachine.c \
 ../stepperMotor.c \
-../stepperMotor2.c \
+../stepperRamp.c \
 ../sw.c \
 ../sysTickDelays.c \
 ../system_msp432p4111.c \
@@ -28,13 +37,22 @@ C_DEPS += \
 ./ClawGame.d \
 ./adc.d \
 ./clocks.d \
+./dma.d \
+./dropPhysics.d \
+./joystickCal.d \
+./joystickFilter.d \
+./joystickMap.d \
 ./lcd.d \
+./lcdFormat.d \
 ./led.d \
+./motionQueue.d \
+./photoSensor.d \
 ./servoDriver.d \
+./snapshot.d \
 ./startup_msp432p4111_ccs.d \
 ./stateMachine.d \
 ./stepperMotor.d \
-./stepperMotor2.d \
+./stepperRamp.d \
 ./sw.d \
 ./sysTickDelays.d \
 ./system_msp432p4111.d \
@@ -44,13 +62,22 @@ OBJS += \
 ./ClawGame.obj \
 ./adc.obj \
 ./clocks.obj \
+./dma.obj \
+./dropPhysics.obj \
+./joystickCal.obj \
+./joystickFilter.obj \
+./joystickMap.obj \
 ./lcd.obj \
+./lcdFormat.obj \
 ./led.obj \
+./motionQueue.obj \
+./photoSensor.obj \
 ./servoDriver.obj \
+./snapshot.obj \
 ./startup_msp432p4111_ccs.obj \
 ./stateMachine.obj \
 ./stepperMotor.obj \
-./stepperMotor2.obj \
+./stepperRamp.obj \
 ./sw.obj \
 ./sysTickDelays.obj \
 ./system_msp432p4111.obj \
@@ -60,13 +87,22 @@ OBJS__QUOTED += \
 "ClawGame.obj" \
 "adc.obj" \
 "clocks.obj" \
+"dma.obj" \
+"dropPhysics.obj" \
+"joystickCal.obj" \
+"joystickFilter.obj" \
+"joystickMap.obj" \
 "lcd.obj" \
+"lcdFormat.obj" \
 "led.obj" \
+"motionQueue.obj" \
+"photoSensor.obj" \
 "servoDriver.obj" \
+"snapshot.obj" \
 "startup_msp432p4111_ccs.obj" \
 "stateMachine.obj" \
 "stepperMotor.obj" \
-"stepperMotor2.obj" \
+"stepperRamp.obj" \
 "sw.obj" \
 "sysTickDelays.obj" \
 "system_msp432p4111.obj" \
@@ -76,13 +112,22 @@ C_DEPS__QUOTED += \
 "ClawGame.d" \
 "adc.d" \
 "clocks.d" \
+"dma.d" \
+"dropPhysics.d" \
+"joystickCal.d" \
+"joystickFilter.d" \
+"joystickMap.d" \
 "lcd.d" \
+"lcdFormat.d" \
 "led.d" \
+"motionQueue.d" \
+"photoSensor.d" \
 "servoDriver.d" \
+"snapshot.d" \
 "startup_msp432p4111_ccs.d" \
 "stateMachine.d" \
 "stepperMotor.d" \
-"stepperMotor2.d" \
+"stepperRamp.d" \
 "sw.d" \
 "sysTickDelays.d" \
 "system_msp432p4111.d" \
@@ -92,13 +137,22 @@ C_SRCS__QUOTED += \
 "../ClawGame.c" \
 "../adc.c" \
 "../clocks.c" \
+"../dma.c" \
+"../dropPhysics.c" \
+"../joystickCal.c" \
+"../joystickFilter.c" \
+"../joystickMap.c" \
 "../lcd.c" \
+"../lcdFormat.c" \
 "../led.c" \
+"../motionQueue.c" \
+"../photoSensor.c" \
 "../servoDriver.c" \
+"../snapshot.c" \
 "../startup_msp432p4111_ccs.c" \
 "../stateMachine.c" \
 "../stepperMotor.c" \
-"../stepperMotor2.c" \
+"../stepperRamp.c" \
 "../sw.c" \
 "../sysTickDelays.c" \
 "../system_msp432p4111.c" \
@@ -1,7 +1,10 @@
 /*
  * adc.c
  *
- * Description: Initialization and ISR for ADC14 captures
+ * Description: Initialization of timer-paced ADC14 captures. The uDMA
+ *              copies each sequence from ADC14MEM0 into adcSequence, and
+ *              the Timer_A0 frame interrupt adds it up and decimates the
+ *              frame into a ring of sample frames
  *
  *  Created on: Jan 30, 2023
  *      Author: Vineet Ranade & Yao Xiong
@@ -9,42 +12,262 @@
 
 #include "adc.h"
 
+#if (ADC_RING_FRAMES & (ADC_RING_FRAMES - 1)) != 0
+#error "ADC_RING_FRAMES must be a power of two"
+#endif
+
+#if ADC_OVERSAMPLE_JOY > ADC_SAMPLE_FRAC || ADC_OVERSAMPLE_PHOTO > ADC_SAMPLE_FRAC
+#error "Frame samples have no room for that many oversampling bits"
+#endif
+
+#if ADC_CHANNELS != ADC_JOYSTICKS + ADC_PRIZE_SENSORS
+#error "Every entry of adcChannels needs a role counted in adc.h"
+#endif
+
+// Conversions of a channel in each sequence with the frame split as far
+//  as it goes, see planSequences()
+#define ADC_CONVERSIONS(n)      (1 << (2 * (n)))
+#define ADC_MIN_REPEATS(n)      ((ADC_CONVERSIONS(n) > ADC_MAX_SEQUENCES) \
+                                    ? ADC_CONVERSIONS(n) / ADC_MAX_SEQUENCES : 1)
+
+#if ADC_JOYSTICKS * ADC_MIN_REPEATS(ADC_OVERSAMPLE_JOY) \
+        + ADC_PRIZE_SENSORS * ADC_MIN_REPEATS(ADC_OVERSAMPLE_PHOTO) > ADC_MEMORIES
+#error "The channels do not fit ADC_MAX_SEQUENCES sequences of ADC_MEMORIES conversions"
+#endif
+
+#if ADC_SAMPLE_FRAC != JOY_SAMPLE_FRAC
+#error "The joystick filters expect frame samples with JOY_SAMPLE_FRAC fractional bits"
+#endif
+
+// Results are read as half words from the 32-bit ADC14MEMx registers, the
+//  whole sequence on one request
+#define ADC_DMA_CONTROL         (DMA_DST_INC_HALF | DMA_DST_SIZE_HALF | DMA_SRC_INC_WORD \
+                                    | DMA_SRC_SIZE_HALF | DMA_ARB_32 | DMA_MODE_BASIC)
+
+const AdcChannel adcChannels[ADC_CHANNELS] =
+{
+    // Input, port, pin, role, oversampling, sample time
+    { 15, 6, ADC_X_BIT, ADC_ROLE_JOYSTICK, ADC_OVERSAMPLE_JOY, ADC14_CTL0_SHT0__16 },
+    { 14, 6, ADC_Y_BIT, ADC_ROLE_JOYSTICK, ADC_OVERSAMPLE_JOY, ADC14_CTL0_SHT0__16 },
+    { 1, 5, ADC_PHOTO, ADC_ROLE_PRIZE, ADC_OVERSAMPLE_PHOTO, ADC14_CTL0_SHT0__16 },
+    { 3, 5, ADC_PHOTO_2, ADC_ROLE_PRIZE, ADC_OVERSAMPLE_PHOTO, ADC14_CTL0_SHT0__16 },
+};
+
+const JoystickFilterConfig defaultJoystickFilter =
+{
+    ADC_JOY_MEDIAN, ADC_JOY_IIR_SHIFT, ADC_JOY_ENTER, ADC_JOY_EXIT,
+    REST_ERROR + 1      // Just outside the dead-zone of the joystick map
+};
+
+JoystickFilter joystickFilters[ADC_JOYSTICKS];
+PhotoSensor photoSensors[ADC_PRIZE_SENSORS];
+
+static AdcFrame adcRing[ADC_RING_FRAMES];
+static AdcSnapshot adcSnapshot;         // Latest frame for the main loop
+static SeqLock adcSnapshotSeq;
+static volatile uint32_t adcFrames;     // Frames completed, the next one goes to slot adcFrames
+static bool adcConverting;              // A sequence was started into adcSequence
+
+// Sequence layout, from adcChannels
+static uint8_t adcRepeats[ADC_CHANNELS];    // Consecutive conversions of each channel
+static uint8_t adcShift[ADC_CHANNELS];      // log2 of its conversions per frame
+static uint8_t adcFrameSequences;       // Sequences per frame
+static uint16_t adcSequenceTicks;       // Timer_A0 CCR2 interval
+uint8_t adcSequenceLength;
+
+// Joystick calibration staged by the main loop, see setJoystickCalibration()
+typedef struct
+{
+    JoystickFilterConfig config;
+    uint16_t centre;
+    uint16_t lo;
+    uint16_t hi;
+} AdcJoystickStage;
+
+static AdcJoystickStage adcJoyStage[ADC_JOYSTICKS];
+static SeqLock adcJoyStageSeq[ADC_JOYSTICKS];
+static uint32_t adcJoyTaken[ADC_JOYSTICKS];     // adcJoyStageSeq of the calibration in use
+static JoystickFilterConfig adcJoyConfig[ADC_JOYSTICKS];    // Its settings, ISR only
+
+static uint16_t adcSequence[ADC_MEMORIES];  // Results of the latest sequence
+static uint32_t adcSum[ADC_CHANNELS];   // Conversions of the frame so far, added up
+static uint8_t adcSequences;            // Sequences added to adcSum
+
+#ifdef ADC_BENCHMARK
+uint32_t adcScanTime;
+#endif
+
+static volatile bool photoLearning;     // Trackers follow the ambient light
+static uint8_t adcPrizeChannel[ADC_PRIZE_SENSORS];  // Position of each prize sensor in adcChannels
+static uint8_t adcPrizeSlot[ADC_PRIZE_SENSORS];     // and its first ADC14MEMx
+
+static WinEvent winEvent;
+static volatile bool winArmed;          // Looking for this round's detection
+static bool winConfirmed;               // A sensor stayed dark, waiting for the others
+static uint8_t winTransit;              // Frames left to wait for them
+static volatile bool winFound;          // winEvent holds this round's detection
+static volatile bool winCrossed;        // A window interrupt in the sequence converting
+static volatile uint32_t winCrossedAt;  // readTimestamp() at the first of them
+static volatile uint16_t winCrossedTicks;   // and the Timer_A0 count
+
+/*!
+ * \brief Hands a pin to the ADC
+ *
+ * \param port Port of the pin
+ * \param pin  Pin bit
+ *
+ * \return None
+ */
+static void selectAnalog(uint8_t port, uint8_t pin)
+{
+    // Tertiary module function
+    switch (port)
+    {
+    case 4:
+        P4->SEL0 |= pin;
+        P4->SEL1 |= pin;
+        break;
+    case 5:
+        P5->SEL0 |= pin;
+        P5->SEL1 |= pin;
+        break;
+    case 6:
+        P6->SEL0 |= pin;
+        P6->SEL1 |= pin;
+        break;
+    case 8:
+        P8->SEL0 |= pin;
+        P8->SEL1 |= pin;
+        break;
+    case 9:
+        P9->SEL0 |= pin;
+        P9->SEL1 |= pin;
+        break;
+    }
+}
+
 /*!
  * \brief Initializes ADC Ports for Use
  *
- * Sets P6.0 and P6.1 to tertiary module function, as well as P5.2 and P5.4
+ * Sets the pin of every channel in adcChannels to tertiary module function
  *
  * \return None
  */
 void initADCPorts(void)
 {
-    resultReady = false;   // Stores whether ADC value is ready
-    ADC_PORT->SEL0 |= ADC_X_BIT;
-    ADC_PORT->SEL1 |= ADC_X_BIT;
-    ADC_PORT->SEL0 |= ADC_Y_BIT;
-    ADC_PORT->SEL1 |= ADC_Y_BIT;
-    ADC_PORT_2->SEL0 |= (ADC_PHOTO | ADC_PHOTO_2);
-    ADC_PORT_2->SEL1 |= (ADC_PHOTO | ADC_PHOTO_2);
+    uint8_t i;
+
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        selectAnalog(adcChannels[i].port, adcChannels[i].pin);
+    }
+}
+
+/*!
+ * \brief Splits the conversions of adcChannels into sequences
+ *
+ * Uses the fewest sequences per frame that fit the ADC14MEMx, each channel
+ *  converted at least once per sequence. A channel with fewer conversions
+ *  than there are sequences is still converted in each of them, so it gets
+ *  more than it asked for. The build-time check at the top makes sure
+ *  ADC_MAX_SEQUENCES sequences are always enough.
+ *
+ * \return None
+ */
+static void planSequences(void)
+{
+    uint8_t i, length, conversions;
+
+    adcFrameSequences = 1;
+    for (;;)
+    {
+        length = 0;
+        for (i = 0; i < ADC_CHANNELS; i++)
+        {
+            conversions = ADC_CONVERSIONS(adcChannels[i].oversample);
+            adcRepeats[i] = (conversions > adcFrameSequences) ? conversions / adcFrameSequences : 1;
+            length += adcRepeats[i];
+        }
+        if (length <= ADC_MEMORIES || adcFrameSequences == ADC_MAX_SEQUENCES)
+        {
+            break;
+        }
+        adcFrameSequences *= 2;
+    }
+
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        conversions = adcRepeats[i] * adcFrameSequences;
+        adcShift[i] = 0;
+        while (conversions > 1)
+        {
+            adcShift[i]++;
+            conversions >>= 1;
+        }
+    }
+    adcSequenceTicks = ADC_FRAME_TICKS / adcFrameSequences;
+    adcSequenceLength = length;
+}
+
+/*!
+ * \brief Decimates the sums of one frame into a sample
+ *
+ * \param sum   Conversions of the channel added up
+ * \param shift log2 of the number of conversions
+ *
+ * \return Mean of the conversions (counts, Q3)
+ */
+static uint16_t decimate(uint32_t sum, uint8_t shift)
+{
+    sum <<= ADC_SAMPLE_FRAC;
+    if (shift > 0)
+    {
+        sum = (sum + (1 << (shift - 1))) >> shift;
+    }
+    return sum;
 }
 
 /*!
  * \brief Configures ADC14 for Use
  *
- * Sequence-of-channels allows multiple ADCs
+ * Sequence-of-channels allows multiple ADCs, each converted several times
+ *  in a row for oversampling. The sequence is built from adcChannels.
+ *  Timer_A0 CCR2 starts a sequence every adcSequenceTicks and the uDMA
+ *  copies the results once the last conversion is done, so no ADC
+ *  conversion interrupt is needed. Timer_A0 must already be running, see
+ *  initializeSwitches().
  *
  * \return None
  */
 void configureADC14(void)
 {
+    const AdcChannel *channel;
+    uint32_t sampleTime = ADC14_CTL0_SHT0__4;
+    uint32_t mctl;
+    uint8_t i, r, slot, prize, joystick;
+
+    planSequences();
+
+    // ADC14MEM0 to 7 and 24 to 31 sample for SHT0, 8 to 23 for SHT1, so
+    //  every conversion gets the longest time in the table
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        if (adcChannels[i].sampleTime > sampleTime)
+        {
+            sampleTime = adcChannels[i].sampleTime;
+        }
+    }
+
     /* Configure ADC (CTL0 and CTL1) registers for:
      *      clock source - default MODCLK, clock prescale 1:1,
      *      sample input signal (SHI) source - software controlled (ADC14SC),
-     *      Pulse Sample mode with sampling period of 16 ADC14CLK cycles,
-     *      Single-channel, single-conversion mode, 10-bit resolution,
-     *      ADC14 conversion start address ADC14MEM1, and Low-power mode
+     *      Pulse Sample mode with sampling period from adcChannels,
+     *      Sequence-of-channels mode, 10-bit resolution,
+     *      ADC14 conversion start address ADC14MEM0, and Low-power mode
      */
     ADC14->CTL0 = ADC14_CTL0_SHP                // Pulse Sample Mode
-                    | ADC14_CTL0_SHT0__16       // 16 cycle sample-and-hold time (for ADC14MEM1)
+                    | sampleTime                // Sample-and-hold time for ADC14MEM0 to 7, 24 to 31
+                    | (sampleTime << 4)         // and for ADC14MEM8 to 23
                     | ADC14_CTL0_PDIV__1        // Predivide by 1
                     | ADC14_CTL0_DIV__1         // /1 clock divider
                     | ADC14_CTL0_SHS_0          // ADC14SC bit sample-and-hold source select
@@ -53,78 +276,511 @@ void configureADC14(void)
                     | ADC14_CTL0_ON;            // ADC14 on
 
     ADC14->CTL1 = ADC14_CTL1_RES__10BIT         // 10-bit conversion results
-            | (0x1 << ADC14_CTL1_CSTARTADD_OFS) // ADC14MEM1 - conversion start address
+            | (0x0 << ADC14_CTL1_CSTARTADD_OFS) // ADC14MEM0 - conversion start address
             | ADC14_CTL1_PWRMD_2;               // Low-power mode
 
-    // Configure ADC14MCTL1 as storage register for result of A15 P6.0
-    //          Single-ended mode with Vref+ = Vcc and Vref- = Vss,
-    //          Input channel - A15, and comparator window disabled
-    ADC14->MCTL[1] = 0x0000000F;
+    // Each channel takes its repeats in consecutive ADC14MEMx, in table
+    //  order. Single-ended mode with Vref+ = Vcc and Vref- = Vss. The first
+    //  two prize sensors have the window comparator, on ADC14LO0/HI0 and
+    //  ADC14LO1/HI1
+    slot = 0;
+    prize = 0;
+    joystick = 0;
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        channel = &adcChannels[i];
+        mctl = channel->input;
+        if (channel->role == ADC_ROLE_PRIZE)
+        {
+            if (prize == 0)
+            {
+                mctl |= ADC14_MCTLN_WINC;
+            }
+            else if (prize == 1)
+            {
+                mctl |= ADC14_MCTLN_WINC | ADC14_MCTLN_WINCTH;
+            }
+            // Readings below the window mean something is covering the
+            //  sensor, armWinDetect() loads the learned thresholds
+            initPhotoSensor(&photoSensors[prize], TOO_DARK);
+            adcPrizeChannel[prize] = i;
+            adcPrizeSlot[prize] = slot;
+            prize++;
+        }
+        else
+        {
+            adcJoyTaken[joystick] = adcJoyStageSeq[joystick];
+            initJoystickFilter(&joystickFilters[joystick++], &defaultJoystickFilter, MID_RANGE);
+        }
 
-    // Configure ADC14MCTL2 as storage register for result of A14 P6.1
-    //          Single-ended mode with Vref+ = Vcc and Vref- = Vss,
-    //          Input channel - A14, and comparator window disabled
-    ADC14->MCTL[2] = 0x000000E;
+        for (r = 0; r < adcRepeats[i]; r++)
+        {
+            ADC14->MCTL[slot++] = mctl;
+        }
+    }
 
-    // Make sure photoVal is greater than 200 upon start
-    photoVal = 1000;
-    // Setup 1st photoresistor ADC (A1)
-    ADC14->MCTL[3] = 0x0000001;
+    // Indicate end of sequence
+    ADC14->MCTL[slot - 1] |= ADC14_MCTLN_EOS;
 
-    // Make sure photoVal2 is greater than 200 upon start
-    photoVal2 = 1000;
-    // Setup 2nd photoresistor ADC, indicating end of sequence (A3)
-    ADC14->MCTL[4] = 0x0000083;
+    ADC14->LO0 = TOO_DARK;
+    ADC14->HI0 = MAX_VAL;
+    ADC14->LO1 = TOO_DARK;
+    ADC14->HI1 = MAX_VAL;
 
-    // Enable ADC conversion complete interrupt
-    ADC14->IER0 = 0x0000001E;
+    // The DMA collects the results, no conversion interrupts. The window
+    //  interrupt is enabled by armWinDetect()
+    ADC14->IER0 = 0;
+    ADC14->IER1 = 0;
+    winArmed = false;
+    winFound = false;
+    photoLearning = true;
 
     // Enable ADC interrupt in NVIC module
     NVIC->ISER[0] |= (1 << ADC14_IRQn);
+
+    // Until the first sequence lands, every frame reads as a centred joystick
+    //  and brightly lit photoresistors, so nothing moves and nobody wins
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        for (r = 0; r < ADC_RING_FRAMES; r++)
+        {
+            adcRing[r].sample[i] = (adcChannels[i].role == ADC_ROLE_JOYSTICK)
+                                        ? ADC_SAMPLE(MID_RANGE) : ADC_SAMPLE(MAX_VAL);
+        }
+        adcSum[i] = 0;
+    }
+    adcFrames = 0;
+    adcConverting = false;
+    adcSequences = 0;
+
+    DMA_Channel->CH_SRCCFG[ADC_DMA_CHANNEL] = ADC_DMA_SOURCE;
+    DMA_PRIMARY(ADC_DMA_CHANNEL)->srcEnd = &ADC14->MEM[slot - 1];
+    DMA_PRIMARY(ADC_DMA_CHANNEL)->dstEnd = &adcSequence[slot - 1];
+    DMA_Control->ALTCLR = 1 << ADC_DMA_CHANNEL;
+
+    // Enable conversions, the first sequence starts on the next CCR2 match
+    ADC14->CTL0 |= ADC14_CTL0_ENC;
+
+    // Timer_A0 CCR2 compare, interrupt enabled
+    TIMER_A0->CCR[2] = TIMER_A0->R + adcSequenceTicks;
+    TIMER_A0->CCTL[2] = TIMER_A_CCTLN_CCIE;
 }
 
-void adcSample(void)
+/*!
+ * \brief Loads the threshold of a prize sensor into its window comparator
+ *
+ * \param prize     Position among the prize sensors
+ * \param threshold Readings below this interrupt, 0 for none
+ *
+ * \return None
+ */
+static void setWindow(uint8_t prize, uint16_t threshold)
 {
-    ADC14->CTL0 |= 0x00000003;
+    if (prize == 0)
+    {
+        ADC14->LO0 = threshold;
+    }
+    else if (prize == 1)
+    {
+        ADC14->LO1 = threshold;
+    }
 }
 
 /*!
- * \brief ADC14 interrupt service routine
+ * \brief Records the time a prize sensor went dark
  *
- * Acts upon potentiometer or photoresistor input, adjusting
- * the stepper speed and servo angle accordingly
+ * Turns its window comparator off, so that only the others interrupt.
+ *
+ * \param prize       Position among the prize sensors
+ * \param timestamp   readTimestamp() when it went dark
+ * \param buttonTicks Timer_A0 count then
  *
  * \return None
  */
-void ADC14_IRQHandler(void)
+static void stampSensor(uint8_t prize, uint32_t timestamp, uint16_t buttonTicks)
+{
+    if (winEvent.darkened == 0)
+    {
+        winEvent.timestamp = timestamp;
+        winEvent.buttonTicks = buttonTicks;
+    }
+    winEvent.darkAt[prize] = timestamp;
+    winEvent.darkened |= WIN_SENSOR(prize);
+    setWindow(prize, 0);
+}
+
+/*!
+ * \brief Tells whether a conversion of a prize sensor is below its window
+ *
+ * \param prize Position among the prize sensors
+ *
+ * \return true if any conversion of the latest complete sequence is
+ */
+static bool belowWindow(uint8_t prize)
+{
+    uint8_t slot = adcPrizeSlot[prize];
+    uint8_t end = slot + adcRepeats[adcPrizeChannel[prize]];
+
+    for (; slot < end; slot++)
+    {
+        if (adcSequence[slot] < photoSensors[prize].threshold)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * \brief Finds the prize sensors behind the window interrupts of the latest
+ *  complete sequence
+ *
+ * While the sequence ran, the later ADC14MEMx still held the sequence
+ *  before, so the interrupt only notes the time and the sensors are told
+ *  apart here, from the copy the DMA made. Called between two sequences,
+ *  so no window interrupt can come in meanwhile.
+ *
+ * \return None
+ */
+static void checkWindow(void)
+{
+    uint8_t i;
+
+    if (!winCrossed)
+    {
+        return;
+    }
+    winCrossed = false;
+    if (!winArmed)
+    {
+        return;
+    }
+
+    for (i = 0; i < ADC_PRIZE_SENSORS && i < 2; i++)
+    {
+        if (!(winEvent.darkened & WIN_SENSOR(i)) && belowWindow(i))
+        {
+            stampSensor(i, winCrossedAt, winCrossedTicks);
+        }
+    }
+}
+
+/*!
+ * \brief Looks for a win among the prize sensors
+ *
+ * \param dark WIN_SENSOR() of each prize sensor confirmed dark this frame
+ *
+ * \return None
+ */
+static void checkWin(uint8_t dark)
+{
+    uint8_t i;
+    bool running = false;
+
+    if (!winArmed)
+    {
+        return;
+    }
+
+    for (i = 0; i < ADC_PRIZE_SENSORS; i++)
+    {
+        if (photoSensors[i].run != 0)
+        {
+            running = true;
+
+            // No comparator, or dark since before the round started, so the
+            //  comparator never saw the reading cross
+            if (!(winEvent.darkened & WIN_SENSOR(i)))
+            {
+                stampSensor(i, readTimestamp(), TIMER_A0->R);
+            }
+        }
+        if (dark & WIN_SENSOR(i))
+        {
+            winEvent.confidence[i] = photoSensors[i].confidence;
+        }
+    }
+
+    if (!winConfirmed)
+    {
+        if (dark)
+        {
+            winConfirmed = true;
+            winTransit = WIN_TRANSIT_FRAMES;
+        }
+        else if (winEvent.darkened && !running)
+        {
+            // Too short to be a prize, a flicker or a passing shadow
+            winEvent.darkened = 0;
+            for (i = 0; i < ADC_PRIZE_SENSORS; i++)
+            {
+                setWindow(i, photoSensors[i].threshold);
+            }
+            return;
+        }
+    }
+
+    if (winConfirmed)
+    {
+        winEvent.sensors |= dark;
+        if (winEvent.darkened == WIN_ALL_SENSORS || --winTransit == 0)
+        {
+            ADC14->IER1 &= ~ADC14_IER1_LOIE;
+            winArmed = false;
+            winFound = true;
+        }
+    }
+}
+
+/*!
+ * \brief Adds the conversions of one sequence to the frame sums
+ *
+ * \return None
+ */
+static void addSequence(void)
+{
+    const uint16_t *result = adcSequence;
+    uint8_t i, r;
+
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        for (r = 0; r < adcRepeats[i]; r++)
+        {
+            adcSum[i] += *result++;
+        }
+    }
+    adcSequences++;
+}
+
+/*!
+ * \brief Takes over the joystick calibrations staged since the last frame
+ *
+ * A calibration the main loop is still writing stays staged until the next
+ *  frame.
+ *
+ * \return None
+ */
+static void takeJoystickStage(void)
+{
+    AdcJoystickStage stage;
+    uint32_t start;
+    uint8_t i;
+
+    for (i = 0; i < ADC_JOYSTICKS; i++)
+    {
+        if (!seqTryReadBegin(&adcJoyStageSeq[i], &start) || start == adcJoyTaken[i])
+        {
+            continue;
+        }
+        stage = adcJoyStage[i];
+        if (seqReadRetry(&adcJoyStageSeq[i], start))
+        {
+            continue;
+        }
+
+        adcJoyConfig[i] = stage.config;
+        joystickFilters[i].config = &adcJoyConfig[i];
+        setJoystickRange(&joystickFilters[i], stage.centre, stage.lo, stage.hi);
+        adcJoyTaken[i] = start;
+    }
+}
+
+/*!
+ * \brief Decimates the frame sums into the ring and publishes the frame
+ *
+ * Every sample goes to the consumer of its role.
+ *
+ * \return None
+ */
+static void finishFrame(void)
+{
+    AdcFrame *done = &adcRing[adcFrames & (ADC_RING_FRAMES - 1)];
+    uint8_t i, prize = 0, joystick = 0, dark = 0;
+    uint16_t sample;
+
+    takeJoystickStage();
+
+    seqWriteBegin(&adcSnapshotSeq);
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        sample = decimate(adcSum[i], adcShift[i]);
+        done->sample[i] = sample;
+        adcSnapshot.sample[i] = sample;
+        adcSum[i] = 0;
+
+        switch (adcChannels[i].role)
+        {
+        case ADC_ROLE_JOYSTICK:
+            adcSnapshot.deflection[joystick] = filterJoystick(&joystickFilters[joystick], sample);
+            joystick++;
+            break;
+        case ADC_ROLE_PRIZE:
+            if (updatePhotoSensor(&photoSensors[prize], ADC_COUNTS(sample), photoLearning))
+            {
+                dark |= WIN_SENSOR(prize);
+            }
+            prize++;
+            break;
+        }
+    }
+    adcSequences = 0;
+
+    checkWin(dark);
+    adcFrames++;
+    adcSnapshot.frame = adcFrames;
+    seqWriteEnd(&adcSnapshotSeq);
+}
+
+void startAdcFrame(void)
 {
-    // Check if interrupt triggered by ADC14MEM1 conversion value loaded
-    if (ADC14->IFGR0 & ADC14_IFGR0_IFG1)
+#ifdef ADC_BENCHMARK
+    uint32_t start;
+#endif
+
+    TIMER_A0->CCR[2] += adcSequenceTicks;
+    // Fell a period behind, e.g. held up by the button debounce: restart the
+    //  cadence from now instead of waiting for the timer to roll over
+    if ((uint16_t)(TIMER_A0->CCR[2] - TIMER_A0->R) > adcSequenceTicks)
     {
-        xVal = ADC14->MEM[1];
-        resultReady = true;
-        // not necessary to clear flag because reading ADC14MEMx clears flag
+        TIMER_A0->CCR[2] = TIMER_A0->R + adcSequenceTicks;
     }
-    // Check if interrupt triggered by ADC14MEM2 conversion value loaded
-    if (ADC14->IFGR0 & ADC14_IFGR0_IFG2)
+
+    // The ADC requests the DMA once the whole sequence is converted, and the
+    //  channel disables itself after copying it
+    if (DMA_Control->ENASET & (1 << ADC_DMA_CHANNEL))
     {
-        yVal = ADC14->MEM[2];
-        resultReady = true;
-        // not necessary to clear flag because reading ADC14MEMx clears flag
+        return;
     }
-    // Check if interrupt triggered by ADC14MEM3 conversion value loaded
-    if (ADC14->IFGR0 & ADC14_IFGR0_IFG3)
+
+    if (adcConverting)
     {
-        photoVal = ADC14->MEM[3];
-        resultReady = true;
-        // not necessary to clear flag because reading ADC14MEMx clears flag
+        addSequence();
+        checkWindow();
+        if (adcSequences == adcFrameSequences)
+        {
+            finishFrame();
+        }
     }
 
-    // Check if interrupt triggered by ADC14MEM4 conversion value loaded
-    if (ADC14->IFGR0 & ADC14_IFGR0_IFG4)
+    DMA_PRIMARY(ADC_DMA_CHANNEL)->control = ADC_DMA_CONTROL | DMA_COUNT(adcSequenceLength);
+    DMA_Control->ENASET = 1 << ADC_DMA_CHANNEL;
+
+    adcConverting = true;
+    ADC14->CTL0 |= ADC14_CTL0_SC;
+
+#ifdef ADC_BENCHMARK
+    // Times the sequence by waiting it out, in benchmark builds only
+    start = readTimestamp();
+    while (ADC14->CTL0 & ADC14_CTL0_BUSY);
+    adcScanTime = readTimestamp() - start;
+#endif
+}
+
+uint32_t adcFrameCount(void)
+{
+    return adcFrames;
+}
+
+const AdcFrame *adcFrame(uint8_t age)
+{
+    return &adcRing[(adcFrames - 1 - age) & (ADC_RING_FRAMES - 1)];
+}
+
+void readAdcSnapshot(AdcSnapshot *snapshot)
+{
+    uint32_t start;
+
+    do
+    {
+        start = seqReadBegin(&adcSnapshotSeq);
+        *snapshot = adcSnapshot;
+    } while (seqReadRetry(&adcSnapshotSeq, start));
+}
+
+void setJoystickFilter(uint8_t sample, const JoystickFilterConfig *config)
+{
+    // A single pointer store, so the ISR sees either the old or the new one
+    joystickFilters[sample].config = config;
+}
+
+void setJoystickCalibration(uint8_t sample, const JoystickFilterConfig *config, uint16_t centre,
+                            uint16_t lo, uint16_t hi)
+{
+    AdcJoystickStage *stage = &adcJoyStage[sample];
+
+    seqWriteBegin(&adcJoyStageSeq[sample]);
+    stage->config = *config;
+    stage->centre = centre;
+    stage->lo = lo;
+    stage->hi = hi;
+    seqWriteEnd(&adcJoyStageSeq[sample]);
+}
+
+void learnAmbientLight(void)
+{
+    ADC14->IER1 &= ~ADC14_IER1_LOIE;
+    winArmed = false;
+    photoLearning = true;
+}
+
+void armWinDetect(void)
+{
+    uint8_t i;
+
+    ADC14->IER1 &= ~ADC14_IER1_LOIE;
+    winArmed = false;
+
+    // The trackers stop changing their thresholds from here on
+    photoLearning = false;
+    for (i = 0; i < ADC_PRIZE_SENSORS; i++)
+    {
+        winEvent.confidence[i] = 0;
+        setWindow(i, photoSensors[i].threshold);
+    }
+
+    winEvent.sensors = 0;
+    winEvent.darkened = 0;
+    winConfirmed = false;
+    winFound = false;
+    ADC14->CLRIFGR1 = ADC14_CLRIFGR1_CLRLOIFG;
+    winCrossed = false;
+    winArmed = true;
+    ADC14->IER1 |= ADC14_IER1_LOIE;
+}
+
+bool winDetected(WinEvent *event)
+{
+    if (!winFound)
+    {
+        return false;
+    }
+    // Written before winFound was set and not again until re-armed
+    *event = winEvent;
+    return true;
+}
+
+/*!
+ * \brief ADC14 interrupt service routine
+ *
+ * Window comparator: a reading of one of the first two prize sensors fell
+ *  below its threshold. Records when, and leaves it to checkWindow() to
+ *  find which sensor once the sequence is complete, and to the trackers
+ *  to confirm, see checkWin().
+ *
+ * \return None
+ */
+void ADC14_IRQHandler(void)
+{
+    uint32_t timestamp = readTimestamp();
+
+    if (ADC14->IFGR1 & ADC14_IFGR1_LOIFG)
     {
-        photoVal2 = ADC14->MEM[4];
-        resultReady = true;
-        // not necessary to clear flag because reading ADC14MEMx clears flag
+        ADC14->CLRIFGR1 = ADC14_CLRIFGR1_CLRLOIFG;
+        if (winArmed && !winCrossed)
+        {
+            winCrossedAt = timestamp;
+            winCrossedTicks = TIMER_A0->R;
+            winCrossed = true;
+        }
     }
 }
@@ -1,7 +1,8 @@
 /*
  * adc.h
  *
- * Description: Header file for 4 ten-bit ADCs used in the project.
+ * Description: Header file for 4 ten-bit ADCs used in the project,
+ *              oversampled to up to 13 bits.
  *
  *  Created on: Jan 30, 2023
  *      Author: Vineet Ranade & Yao Xiong
@@ -23,6 +24,11 @@ extern "C"
 
 #include <msp.h>
 #include <stdbool.h>
+#include "dma.h"
+#include "joystickFilter.h"
+#include "photoSensor.h"
+#include <timer32.h>
+#include "seqlock.h"
 
 /*******************/
 /********ADC********/
@@ -38,17 +44,241 @@ extern "C"
 
 #define MID_RANGE       512                     // Since we use 10 bits, 512 is middle
 #define REST_ERROR      12                      // Error for resting position of joystick
-#define MAX_DIFF        499.0                   // 499.0 for less than, 498.0 for greater than
 #define MAX_VAL         1023                    // 2^10 - 1
-#define TOO_DARK        150                     // Dark range for photoresistors based on experimentation
+#define TOO_DARK        150                     // Dark range for photoresistors until the ambient light is learned
 
-int xVal, yVal, photoVal, photoVal2;            // Variables holding ADC results
-volatile bool resultReady;                      // Stores whether ADC value is ready
+// Roles of the scanned channels. Each role has one consumer, which gets
+//  the channels of that role in table order
+#define ADC_ROLE_JOYSTICK   0                   // Joystick axis, to joystickFilters[]
+#define ADC_ROLE_PRIZE      1                   // Prize-detection photoresistor, to photoSensors[]
 
+typedef struct
+{
+    uint8_t input;                              // ADC14 input channel, An
+    uint8_t port;                               // Port of the input pin: 4, 5, 6, 8 or 9
+    uint8_t pin;                                // Input pin bit
+    uint8_t role;                               // ADC_ROLE_x
+    uint8_t oversample;                         // 4^n conversions per frame, n = 0 to ADC_SAMPLE_FRAC
+    uint32_t sampleTime;                        // ADC14_CTL0_SHT0__x sample-and-hold time
+} AdcChannel;
+
+// Positions in adcChannels, and so in every frame. Joystick axes come first
+#define ADC_SAMPLE_X        0                   // Joystick x-direction, A15
+#define ADC_SAMPLE_Y        1                   // Joystick y-direction, A14
+#define ADC_SAMPLE_PHOTO    2                   // Photoresistor 1, A1
+#define ADC_SAMPLE_PHOTO_2  3                   // Photoresistor 2, A3
+#define ADC_CHANNELS        4                   // Entries in adcChannels
+#define ADC_JOYSTICKS       2                   // Entries with ADC_ROLE_JOYSTICK
+#define ADC_PRIZE_SENSORS   2                   // Entries with ADC_ROLE_PRIZE, up to 8
+
+#define ADC_ACLK_RATE       32768               // Timer_A0 tick rate (ACLK)
+#define ADC_FRAME_RATE      1024                // Frames per second
+#define ADC_FRAME_TICKS     (ADC_ACLK_RATE / ADC_FRAME_RATE)    // Timer_A0 ticks per frame
+#define ADC_RING_FRAMES     16                  // Frames kept, power of two
+
+// Oversampling: each frame sample is the mean of 4^n conversions, which
+//  adds n bits of resolution as long as the input carries some noise.
+//  Every extra bit costs four times the ADC time of that channel. The
+//  channels are converted in one sequence per frame while it fits the 32
+//  ADC14MEMx; beyond that the frame is split into 2, 4 or up to 8
+//  sequences, each with its own Timer_A0 interrupt. So at most 256
+//  conversions per frame. A channel with fewer conversions than there are
+//  sequences is still converted once in every sequence, and its sample is
+//  the mean of those. The default table does not fit one sequence (34
+//  conversions), so it runs 2 sequences of 18: 8 conversions of each
+//  joystick axis and 1 of each photoresistor, 36 per frame, and every
+//  photoresistor sample is the mean of two conversions.
+//
+// Entries take the ADC_OVERSAMPLE_x of their role, which lets adc.c check
+//  at build time that the table fits ADC_MAX_SEQUENCES sequences.
+//
+// Scan time: every conversion takes the sample-and-hold time plus 11
+//  ADC14CLK cycles (MODCLK, 25 MHz), and a sequence is the sum over its
+//  conversions, so it grows linearly with the channels in the table.
+//  ADC_BENCHMARK only times the sequences of the table built in; the scan
+//  rate for another channel count takes a build with that table.
+#define ADC_OVERSAMPLE_JOY      2               // Joystick channels, n = 0 to 3
+#define ADC_OVERSAMPLE_PHOTO    0               // Photoresistor channels, n = 0 to 3
+#define ADC_SAMPLE_FRAC         3               // Fractional bits of frame samples (13 bits)
+#define ADC_SAMPLE(counts)      ((counts) << ADC_SAMPLE_FRAC)   // 10-bit reading as a frame sample
+#define ADC_COUNTS(sample)      (((sample) + (1 << (ADC_SAMPLE_FRAC - 1))) >> ADC_SAMPLE_FRAC)  // and back, rounded
+#define ADC_MEMORIES            32              // ADC14MEM0 to ADC14MEM31
+#define ADC_MAX_SEQUENCES       8               // Sequences per frame at most
+
+// Default joystick filter: 3-sample median, IIR time constant of 16 frames,
+//  dead-zone entered within REST_ERROR / 2 and left beyond 3 / 2 REST_ERROR
+#define ADC_JOY_MEDIAN      3
+#define ADC_JOY_IIR_SHIFT   4
+#define ADC_JOY_ENTER       (REST_ERROR / 2)
+#define ADC_JOY_EXIT        (REST_ERROR * 3 / 2)
+
+#define ADC_DMA_CHANNEL     7                   // uDMA channel of the ADC14 trigger
+#define ADC_DMA_SOURCE      7                   // ADC14 on channel 7
+
+typedef struct
+{
+    uint16_t sample[ADC_CHANNELS];              // Decimated results (counts, Q3), indexed by ADC_SAMPLE_x
+} AdcFrame;
+
+typedef struct
+{
+    uint32_t frame;                             // adcFrameCount() once this frame was done
+    uint16_t sample[ADC_CHANNELS];              // Its decimated results (counts, Q3)
+    int16_t deflection[ADC_JOYSTICKS];          // Filtered joystick deflections after it (counts, Q4)
+} AdcSnapshot;
+
+// Prize sensors found dark, by position among the ADC_ROLE_PRIZE channels
+#define WIN_SENSOR(n)   (1 << (n))
+#define WIN_PHOTO       WIN_SENSOR(0)
+#define WIN_PHOTO_2     WIN_SENSOR(1)
+
+#define WIN_ALL_SENSORS ((1 << ADC_PRIZE_SENSORS) - 1)
+
+// Frames a win waits after it is confirmed, for the other prize sensors to
+//  go dark as the prize falls past them (125 ms)
+#define WIN_TRANSIT_FRAMES  128
+
+typedef struct
+{
+    uint32_t timestamp;                         // readTimestamp() when the first sensor went dark
+    uint16_t buttonTicks;                       // Timer_A0 count then, same clock as lastPressed
+    uint8_t sensors;                            // WIN_SENSOR() of each sensor confirmed dark
+    uint8_t darkened;                           // WIN_SENSOR() of each sensor with a darkAt
+    uint32_t darkAt[ADC_PRIZE_SENSORS];         // readTimestamp() when each sensor went dark
+    uint8_t confidence[ADC_PRIZE_SENSORS];      // Of each prize sensor when last confirmed dark
+} WinEvent;
+
+extern const AdcChannel adcChannels[ADC_CHANNELS];
+
+// Filters of the joystick samples, indexed by ADC_SAMPLE_X and ADC_SAMPLE_Y
+extern JoystickFilter joystickFilters[ADC_JOYSTICKS];
+
+// Ambient-light trackers of the prize sensors, in table order
+extern PhotoSensor photoSensors[ADC_PRIZE_SENSORS];
+extern const JoystickFilterConfig defaultJoystickFilter;
+
+extern uint8_t adcSequenceLength;               // Conversions per sequence
+#ifdef ADC_BENCHMARK
+extern uint32_t adcScanTime;                    // MCLK ticks the latest sequence took
+#endif
 
 extern void configureADC14(void);
 extern void initADCPorts(void);
-extern void adcSample(void);
+
+/*!
+ * \brief Starts the next conversion sequence
+ *
+ * Called from the Timer_A0 CCR2 interrupt, once per sequence. Adds up the
+ *  conversions the DMA copied from the previous sequence, and after the
+ *  last sequence of a frame decimates the sums into the next ring frame,
+ *  hands each sample to the consumer of its role and publishes the frame. Then restarts the DMA and the sequence. If the previous
+ *  sequence has somehow not finished, this period is skipped instead and
+ *  the frame completes one period later.
+ *
+ * \return None
+ */
+extern void startAdcFrame(void);
+
+/*!
+ * \brief Counts the frames completed since configureADC14()
+ *
+ * Free running, so a consumer can remember it and later see how many new
+ *  frames have arrived.
+ *
+ * \return Number of completed frames
+ */
+extern uint32_t adcFrameCount(void);
+
+/*!
+ * \brief Gets a completed frame from the ring, without waiting
+ *
+ * \param age 0 for the latest frame, up to ADC_RING_FRAMES - 2 for older ones
+ *
+ * \return The frame, which stays intact for at least ADC_RING_FRAMES - 2 - age
+ *         more frame periods
+ */
+extern const AdcFrame *adcFrame(uint8_t age);
+
+/*!
+ * \brief Learns the ambient light on the photoresistors
+ *
+ * Call while no prize can be dropped. Disarms win detection, and keeps
+ *  learning until armWinDetect().
+ *
+ * \return None
+ */
+extern void learnAmbientLight(void);
+
+/*!
+ * \brief Arms win detection for a new round
+ *
+ * Stops learning and loads the learned thresholds into the ADC14 window
+ *  comparators. The first conversion of each photoresistor below its
+ *  threshold interrupts and is timestamped, and once the sequence is
+ *  complete that sensor's comparator is turned off so the other one can
+ *  still be timed. Sensors without a
+ *  comparator are timestamped from the frame instead. A win is confirmed
+ *  once a tracker has seen PHOTO_CONFIRM dark frames in a row; if every
+ *  sensor brightens before that, the timestamps are dropped and the
+ *  comparators re-armed. The win is reported when every sensor has gone
+ *  dark, or WIN_TRANSIT_FRAMES after it was confirmed. Any event from an
+ *  earlier round is dropped.
+ *
+ * \return None
+ */
+extern void armWinDetect(void);
+
+/*!
+ * \brief Checks for a win since armWinDetect(), without waiting
+ *
+ * \param event Receives the detection time and sensors if there was one
+ *
+ * \return true if a photoresistor stayed dark for PHOTO_CONFIRM frames
+ */
+extern bool winDetected(WinEvent *event);
+
+/*!
+ * \brief Copies the latest frame and the joystick deflections it gave
+ *
+ * All of it comes from the same frame. Main loop only, see seqlock.h.
+ *
+ * \param snapshot Receives the frame
+ *
+ * \return None
+ */
+extern void readAdcSnapshot(AdcSnapshot *snapshot);
+
+/*!
+ * \brief Changes the filter settings of a joystick axis
+ *
+ * Takes effect from the next frame. The history and state are kept, so
+ *  this can be called while frames are being sampled.
+ *
+ * \param sample ADC_SAMPLE_X or ADC_SAMPLE_Y
+ * \param config New settings, kept by reference
+ *
+ * \return None
+ */
+extern void setJoystickFilter(uint8_t sample, const JoystickFilterConfig *config);
+
+/*!
+ * \brief Changes the settings, rest position and throw of a joystick axis
+ *
+ * Staged behind a sequence counter, see seqlock.h, and taken over by the
+ *  frame interrupt between two frames, so no frame is filtered with part
+ *  of the old and part of the new calibration. The history and state are
+ *  kept. Main loop only.
+ *
+ * \param sample ADC_SAMPLE_X or ADC_SAMPLE_Y
+ * \param config New settings, copied
+ * \param centre Reading of the axis at rest
+ * \param lo     Lowest reading the axis reaches
+ * \param hi     Highest reading the axis reaches
+ *
+ * \return None
+ */
+extern void setJoystickCalibration(uint8_t sample, const JoystickFilterConfig *config, uint16_t centre,
+                                   uint16_t lo, uint16_t hi);
 
 //*****************************************************************************
 //
@@ -0,0 +1,86 @@
+/*! \file */
+/*!
+ * cycleCounter.h
+ *
+ * Description: Cortex-M4 DWT cycle counter helpers for timing code sections
+ *              on the MSP432P4111. Counts MCLK cycles (12 MHz).
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef CYCLECOUNTER_H_
+#define CYCLECOUNTER_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+
+typedef struct
+{
+    uint32_t count;         // Number of timed runs
+    uint32_t total;         // Sum of cycles over all runs
+    uint32_t worst;         // Longest single run in cycles
+} CycleStats;
+
+/*!
+ * \brief Starts the free-running DWT cycle counter
+ *
+ * \return None
+ */
+static inline void initCycleCounter(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*!
+ * \brief Reads the DWT cycle counter
+ *
+ * \return Current cycle count
+ */
+static inline uint32_t readCycleCounter(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*!
+ * \brief Adds one timed run to \a stats
+ *
+ * \param stats Statistics to update
+ * \param start Cycle count read at the start of the run
+ *
+ * \return None
+ */
+static inline void recordCycles(CycleStats *stats, uint32_t start)
+{
+    uint32_t cycles = DWT->CYCCNT - start;
+
+    stats->count++;
+    stats->total += cycles;
+    if (cycles > stats->worst)
+    {
+        stats->worst = cycles;
+    }
+}
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CYCLECOUNTER_H_ */
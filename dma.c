@@ -0,0 +1,34 @@
+/*! \file */
+/*!
+ * dma.c
+ *
+ * Description: uDMA controller setup for MSP432P4111 Launchpad. The control
+ *              table has to be aligned to its own size so the controller can
+ *              index it by channel number.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "dma.h"
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma DATA_ALIGN(dmaControlTable, 256)
+DmaControlEntry dmaControlTable[2 * DMA_CHANNELS];
+#else
+DmaControlEntry dmaControlTable[2 * DMA_CHANNELS] __attribute__((aligned(256)));
+#endif
+
+void initDma(void)
+{
+    uint8_t ch;
+
+    // No channel may run from a stale control word
+    for (ch = 0; ch < 2 * DMA_CHANNELS; ch++)
+    {
+        dmaControlTable[ch].control = DMA_MODE_STOP;
+    }
+
+    DMA_Control->CTLBASE = (uint32_t)dmaControlTable;
+    DMA_Control->CFG = DMA_CFG_MASTEN;
+}
@@ -0,0 +1,97 @@
+/*! \file */
+/*!
+ * dma.h
+ *
+ * Description: uDMA controller setup for MSP432P4111 Launchpad. Owns the
+ *              channel control table shared by every module that moves data
+ *              with DMA, and the bit fields of its channel control word.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef DMA_H_
+#define DMA_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+
+#define DMA_CHANNELS                    8
+
+/* Channel control word fields */
+#define DMA_DST_INC_BYTE                (0x0UL << 30)
+#define DMA_DST_INC_HALF                (0x1UL << 30)
+#define DMA_DST_INC_WORD                (0x2UL << 30)
+#define DMA_DST_INC_NONE                (0x3UL << 30)
+#define DMA_DST_SIZE_BYTE               (0x0UL << 28)
+#define DMA_DST_SIZE_HALF               (0x1UL << 28)
+#define DMA_DST_SIZE_WORD               (0x2UL << 28)
+#define DMA_SRC_INC_BYTE                (0x0UL << 26)
+#define DMA_SRC_INC_HALF                (0x1UL << 26)
+#define DMA_SRC_INC_WORD                (0x2UL << 26)
+#define DMA_SRC_INC_NONE                (0x3UL << 26)
+#define DMA_SRC_SIZE_BYTE               (0x0UL << 24)
+#define DMA_SRC_SIZE_HALF               (0x1UL << 24)
+#define DMA_SRC_SIZE_WORD               (0x2UL << 24)
+#define DMA_ARB_1                       (0x0UL << 14)   // Re-arbitrate after every transfer
+#define DMA_ARB_4                       (0x2UL << 14)   // Four transfers per request
+#define DMA_ARB_32                      (0x5UL << 14)   // Up to 32 transfers per request
+#define DMA_COUNT(n)                    (((uint32_t)(n) - 1) << 4)  // 1 to 1024 transfers
+#define DMA_MODE_STOP                   0x0UL
+#define DMA_MODE_BASIC                  0x1UL
+#define DMA_MODE_PINGPONG               0x3UL
+#define DMA_MODE_MASK                   0x7UL
+
+// Transfers a structure has left, from its control word
+#define DMA_TRANSFERS_LEFT(control)     ((((control) & DMA_MODE_MASK) == DMA_MODE_STOP) ? 0 \
+                                            : ((((control) >> 4) & 0x3FF) + 1))
+
+/*!
+ * One entry of the channel control table
+ */
+typedef struct
+{
+    volatile void *srcEnd;          // Address of the last source item
+    volatile void *dstEnd;          // Address of the last destination item
+    volatile uint32_t control;      // Channel control word
+    uint32_t spare;
+} DmaControlEntry;
+
+// Primary structures of every channel, followed by the alternate ones
+extern DmaControlEntry dmaControlTable[2 * DMA_CHANNELS];
+
+#define DMA_PRIMARY(ch)                 (&dmaControlTable[(ch)])
+#define DMA_ALTERNATE(ch)               (&dmaControlTable[DMA_CHANNELS + (ch)])
+
+/*!
+ * \brief This function enables the uDMA controller
+ *
+ * Points the controller at dmaControlTable and turns it on. Channels stay
+ *  disabled until configured by the module that uses them.
+ *
+ * Modified \b DMA_CTLBASE and \b DMA_CFG registers.
+ *
+ * \return None
+ */
+extern void initDma(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_H_ */
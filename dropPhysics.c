@@ -0,0 +1,44 @@
+/*! \file */
+/*!
+ * dropPhysics.c
+ *
+ * Description: Drop speed and height of a prize from photoresistor and
+ *              button timings, using integer math only.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "dropPhysics.h"
+
+uint32_t dropSpeed(uint32_t ticks, uint32_t rate)
+{
+    // DROP_SENSOR_SPACING * rate overflows 32 bits above 71 MHz
+    uint64_t speed;
+
+    if (ticks == 0)
+    {
+        return DROP_MAX_SPEED;
+    }
+    speed = ((uint64_t)DROP_SENSOR_SPACING * rate + ticks / 2) / ticks;
+    return (speed > DROP_MAX_SPEED) ? DROP_MAX_SPEED : (uint32_t)speed;
+}
+
+uint32_t heightFromSpeed(uint32_t speed)
+{
+    // h = v^2 / 2g, less the half of the spacing already fallen
+    uint32_t height = (speed * speed + DROP_GRAVITY) / (2 * DROP_GRAVITY);
+
+    return (height > DROP_SENSOR_SPACING / 2) ? height - DROP_SENSOR_SPACING / 2 : 0;
+}
+
+uint32_t heightFromFallTime(uint32_t ticks)
+{
+    // h = g t^2 / 2, with t = ticks / 2^15: ticks^2 fits in 2^30 for up to
+    //  a second, shifted down by 12 before multiplying and 19 after
+    if (ticks > 32768)
+    {
+        ticks = 32768;
+    }
+    return (((ticks * ticks) >> 12) * DROP_GRAVITY) >> 19;
+}
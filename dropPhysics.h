@@ -0,0 +1,80 @@
+/*! \file */
+/*!
+ * dropPhysics.h
+ *
+ * Description: Fixed-point estimates of how far a prize fell, for the drop
+ *              bonus. With both photoresistors timed, the transit time
+ *              between them gives the speed of the prize, and a prize
+ *              falling from rest reaches that speed after falling
+ *              v^2 / 2g. With only one, the time since the claw opened
+ *              gives g t^2 / 2 instead, which also counts the time the
+ *              gripper takes to let go.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef DROPPHYSICS_H_
+#define DROPPHYSICS_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+
+#define DROP_GRAVITY            9807        // mm/s^2
+#define DROP_SENSOR_SPACING     60          // mm from the upper photoresistor down to the lower one
+#define DROP_UPPER_SENSOR       0           // Prize sensor passed first, see adcChannels
+#define DROP_LOWER_SENSOR       1
+#define DROP_MAX_SPEED          65535       // mm/s, keeps the square in 32 bits
+
+/*!
+ * \brief Speed of a prize from its transit between the photoresistors
+ *
+ * \param ticks Time from the upper to the lower sensor going dark
+ * \param rate  Ticks per second
+ *
+ * \return Speed (mm/s), at most DROP_MAX_SPEED
+ */
+extern uint32_t dropSpeed(uint32_t ticks, uint32_t rate);
+
+/*!
+ * \brief Distance a prize fell from rest before reaching the upper sensor
+ *
+ * Its mean speed between the sensors is its speed half way through the
+ *  transit, v^2 / 2g below the start, or about half the sensor spacing
+ *  below the upper sensor.
+ *
+ * \param speed Mean speed between the sensors (mm/s), from dropSpeed()
+ *
+ * \return Distance (mm)
+ */
+extern uint32_t heightFromSpeed(uint32_t speed);
+
+/*!
+ * \brief Distance a prize falls from rest in some time
+ *
+ * \param ticks Time of the fall, in 32768 Hz (ACLK) ticks, up to 1 s
+ *
+ * \return Distance (mm)
+ */
+extern uint32_t heightFromFallTime(uint32_t ticks);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DROPPHYSICS_H_ */
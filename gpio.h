@@ -0,0 +1,60 @@
+/*! \file */
+/*!
+ * gpio.h
+ *
+ * Description: Interrupt-safe GPIO output writes for the MSP432P4111 through
+ *              the Cortex-M4 peripheral bit-band region. Every port bit has
+ *              its own 32-bit alias word, and a store to it sets or clears
+ *              that bit alone in a single bus write. A read-modify-write of
+ *              OUT in one interrupt can then never undo a change another
+ *              interrupt made to a different bit of the same port.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef GPIO_H_
+#define GPIO_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+
+// Alias word of bit b (0 to 7) of a port register, usable as an lvalue
+#define GPIO_BIT(reg, b)                BITBAND_PERI(reg, b)
+
+/*!
+ * \brief Finds the bit-band alias of one bit of a port register
+ *
+ * Meant to be called once at initialization, so interrupt handlers only
+ *  store through the returned pointer.
+ *
+ * \param reg Port register, e.g. &P2->OUT
+ * \param bit Bit number, 0 to 7
+ *
+ * \return Alias word of the bit
+ */
+static inline volatile uint32_t *gpioBitAlias(volatile uint8_t *reg, uint8_t bit)
+{
+    return &BITBAND_PERI(*reg, bit);
+}
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GPIO_H_ */
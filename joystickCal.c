@@ -0,0 +1,277 @@
+/*! \file */
+/*!
+ * joystickCal.c
+ *
+ * Description: Automatic joystick calibration from rest windows of ADC
+ *              frames, kept in flash information memory across resets.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "joystickCal.h"
+
+typedef struct
+{
+    uint32_t magic;             // JOY_CAL_MAGIC
+    JoystickCal axis[2];
+    uint32_t check;             // ~(sum of the axis fields)
+} JoystickCalRecord;
+
+JoystickCal joystickCal[2];
+
+// Calibration as last written to flash
+static JoystickCal savedCal[2];
+
+// Calibration moved away from savedCal, see saveJoystickCalibration()
+static bool calSavePending;
+
+// Rest window being collected
+static uint32_t calLastFrame;
+static uint16_t calFrames;
+static uint32_t calSum[2];
+static uint16_t calMin[2];
+static uint16_t calMax[2];
+
+/*!
+ * Checksum of the axis fields of a record
+ *
+ * \param axis Both axes of the record
+ *
+ * \return Checksum
+ */
+static uint32_t recordCheck(const JoystickCal *axis)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+
+    for (i = 0; i < 2; i++)
+    {
+        sum += axis[i].centre + axis[i].noise + axis[i].lo + axis[i].hi;
+    }
+    return ~sum;
+}
+
+/*!
+ * Erases the calibration sector and programs \a record into it
+ *
+ * \param record Record to store, a whole number of words
+ *
+ * \return None
+ */
+static void writeRecord(const JoystickCalRecord *record)
+{
+    volatile uint32_t *dst = (volatile uint32_t *)JOY_CAL_FLASH_ADDR;
+    const uint32_t *src = (const uint32_t *)record;
+    uint8_t i;
+
+    FLCTL_A->BANK1_INFO_WEPROT &= ~FLCTL_A_BANK1_INFO_WEPROT_PROT0;
+
+    // Sector erase of information memory
+    FLCTL_A->ERASE_SECTADDR = JOY_CAL_FLASH_ADDR & 0x3FFFFF;
+    FLCTL_A->ERASE_CTLSTAT = FLCTL_A_ERASE_CTLSTAT_TYPE_1;
+    FLCTL_A->ERASE_CTLSTAT |= FLCTL_A_ERASE_CTLSTAT_START;
+    while ((FLCTL_A->ERASE_CTLSTAT & FLCTL_A_ERASE_CTLSTAT_STATUS_MASK) != FLCTL_A_ERASE_CTLSTAT_STATUS_3);
+    FLCTL_A->ERASE_CTLSTAT = FLCTL_A_ERASE_CTLSTAT_CLR_STAT;
+
+    // Immediate mode, each word is programmed as it is written
+    FLCTL_A->PRG_CTLSTAT = FLCTL_A_PRG_CTLSTAT_ENABLE;
+    for (i = 0; i < sizeof(JoystickCalRecord) / sizeof(uint32_t); i++)
+    {
+        dst[i] = src[i];
+        while (FLCTL_A->PRG_CTLSTAT & FLCTL_A_PRG_CTLSTAT_STATUS_MASK);
+    }
+    FLCTL_A->PRG_CTLSTAT = 0;
+
+    FLCTL_A->BANK1_INFO_WEPROT |= FLCTL_A_BANK1_INFO_WEPROT_PROT0;
+}
+
+/*!
+ * Hands the calibration of one axis to its joystick filter
+ *
+ * \param axis ADC_SAMPLE_X or ADC_SAMPLE_Y
+ *
+ * \return None
+ */
+static void applyCalibration(uint8_t axis)
+{
+    JoystickCal *cal = &joystickCal[axis];
+    JoystickFilterConfig config = defaultJoystickFilter;
+
+    // Dead-zone thresholds widened to the noise band
+    if (cal->noise / 2 > config.enterBand)
+    {
+        config.enterBand = cal->noise / 2;
+        config.exitBand = config.enterBand * 3;
+    }
+    setJoystickCalibration(axis, &config, cal->centre, cal->lo, cal->hi);
+}
+
+/*!
+ * Tells whether two calibrations differ by JOY_CAL_SAVE_DELTA or more
+ *
+ * \param a First calibration
+ * \param b Second calibration
+ *
+ * \return true if any field moved that far
+ */
+static bool calibrationMoved(const JoystickCal *a, const JoystickCal *b)
+{
+    return (a->centre + JOY_CAL_SAVE_DELTA <= b->centre || b->centre + JOY_CAL_SAVE_DELTA <= a->centre)
+        || (a->noise + JOY_CAL_SAVE_DELTA <= b->noise || b->noise + JOY_CAL_SAVE_DELTA <= a->noise)
+        || (a->lo + JOY_CAL_SAVE_DELTA <= b->lo || b->lo + JOY_CAL_SAVE_DELTA <= a->lo)
+        || (a->hi + JOY_CAL_SAVE_DELTA <= b->hi || b->hi + JOY_CAL_SAVE_DELTA <= a->hi);
+}
+
+/*!
+ * Starts a new rest window
+ *
+ * \return None
+ */
+static void restartWindow(void)
+{
+    uint8_t axis;
+
+    calFrames = 0;
+    for (axis = 0; axis < 2; axis++)
+    {
+        calSum[axis] = 0;
+        calMin[axis] = MAX_VAL;
+        calMax[axis] = 0;
+    }
+}
+
+void initJoystickCalibration(void)
+{
+    const JoystickCalRecord *stored = (const JoystickCalRecord *)JOY_CAL_FLASH_ADDR;
+    uint8_t axis;
+
+    if (stored->magic == JOY_CAL_MAGIC && stored->check == recordCheck(stored->axis))
+    {
+        joystickCal[ADC_SAMPLE_X] = stored->axis[ADC_SAMPLE_X];
+        joystickCal[ADC_SAMPLE_Y] = stored->axis[ADC_SAMPLE_Y];
+    }
+    else
+    {
+        for (axis = 0; axis < 2; axis++)
+        {
+            // Widened as soon as the stick is pushed further
+            joystickCal[axis].centre = MID_RANGE;
+            joystickCal[axis].noise = 0;
+            joystickCal[axis].lo = MID_RANGE - JOY_CAL_MIN_SPAN;
+            joystickCal[axis].hi = MID_RANGE + JOY_CAL_MIN_SPAN;
+        }
+    }
+
+    for (axis = 0; axis < 2; axis++)
+    {
+        savedCal[axis] = joystickCal[axis];
+        applyCalibration(axis);
+    }
+
+    calLastFrame = adcFrameCount();
+    restartWindow();
+}
+
+bool calibrateJoystick(void)
+{
+    uint32_t count = adcFrameCount();
+    uint32_t fresh = count - calLastFrame;
+    const AdcFrame *frame;
+    uint16_t centre, sample;
+    uint8_t axis;
+
+    // Older frames than that may already be overwritten
+    if (fresh > ADC_RING_FRAMES - 2)
+    {
+        fresh = ADC_RING_FRAMES - 2;
+    }
+    calLastFrame = count;
+
+    while (fresh > 0 && calFrames < JOY_CAL_FRAMES)
+    {
+        frame = adcFrame(--fresh);
+        for (axis = 0; axis < 2; axis++)
+        {
+            sample = ADC_COUNTS(frame->sample[axis]);
+            calSum[axis] += sample;
+            if (sample < calMin[axis])
+            {
+                calMin[axis] = sample;
+            }
+            if (sample > calMax[axis])
+            {
+                calMax[axis] = sample;
+            }
+        }
+        calFrames++;
+    }
+
+    if (calFrames < JOY_CAL_FRAMES)
+    {
+        return false;
+    }
+
+    // Both axes have to be steady and near the middle, or someone was
+    //  holding the joystick
+    for (axis = 0; axis < 2; axis++)
+    {
+        centre = (calSum[axis] + JOY_CAL_FRAMES / 2) / JOY_CAL_FRAMES;
+        if (calMax[axis] - calMin[axis] > JOY_CAL_MAX_SPREAD
+            || centre + JOY_CAL_MAX_OFFSET < MID_RANGE || centre > MID_RANGE + JOY_CAL_MAX_OFFSET)
+        {
+            restartWindow();
+            return false;
+        }
+    }
+
+    for (axis = 0; axis < 2; axis++)
+    {
+        JoystickCal *cal = &joystickCal[axis];
+
+        cal->centre = (calSum[axis] + JOY_CAL_FRAMES / 2) / JOY_CAL_FRAMES;
+        cal->noise = (calMax[axis] - cal->centre > cal->centre - calMin[axis])
+                        ? calMax[axis] - cal->centre : cal->centre - calMin[axis];
+
+        // Extremes the filter has seen, assuming at least JOY_CAL_MIN_SPAN
+        cal->lo = joystickFilters[axis].lo;
+        cal->hi = joystickFilters[axis].hi;
+        if (cal->lo > cal->centre - JOY_CAL_MIN_SPAN)
+        {
+            cal->lo = cal->centre - JOY_CAL_MIN_SPAN;
+        }
+        if (cal->hi < cal->centre + JOY_CAL_MIN_SPAN)
+        {
+            cal->hi = cal->centre + JOY_CAL_MIN_SPAN;
+        }
+        applyCalibration(axis);
+    }
+    restartWindow();
+
+    if (calibrationMoved(&joystickCal[ADC_SAMPLE_X], &savedCal[ADC_SAMPLE_X])
+        || calibrationMoved(&joystickCal[ADC_SAMPLE_Y], &savedCal[ADC_SAMPLE_Y]))
+    {
+        calSavePending = true;
+    }
+    return true;
+}
+
+bool saveJoystickCalibration(void)
+{
+    JoystickCalRecord record;
+
+    if (!calSavePending)
+    {
+        return false;
+    }
+
+    record.magic = JOY_CAL_MAGIC;
+    record.axis[ADC_SAMPLE_X] = joystickCal[ADC_SAMPLE_X];
+    record.axis[ADC_SAMPLE_Y] = joystickCal[ADC_SAMPLE_Y];
+    record.check = recordCheck(record.axis);
+    writeRecord(&record);
+    savedCal[ADC_SAMPLE_X] = joystickCal[ADC_SAMPLE_X];
+    savedCal[ADC_SAMPLE_Y] = joystickCal[ADC_SAMPLE_Y];
+    calSavePending = false;
+    return true;
+}
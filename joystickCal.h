@@ -0,0 +1,101 @@
+/*! \file */
+/*!
+ * joystickCal.h
+ *
+ * Description: Automatic joystick calibration. While nobody should be
+ *              touching the joystick (resetting and countdown), windows of
+ *              ADC frames are checked for a steady rest position. Each
+ *              steady window sets the per-axis centre and noise band that
+ *              the joystick filters use, and the throw extremes the filters
+ *              have seen are carried along with them. The result is kept
+ *              in flash information memory so the next boot starts with it.
+ *              Writing it stalls the CPU, so that is left for a moment the
+ *              steppers are at rest (see saveJoystickCalibration()).
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef JOYSTICKCAL_H_
+#define JOYSTICKCAL_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+#include <stdbool.h>
+#include "adc.h"
+
+#define JOY_CAL_FRAMES          256                 // Frames per rest window (250 ms)
+#define JOY_CAL_MAX_SPREAD      (REST_ERROR * 4)    // Largest max - min of a steady window
+#define JOY_CAL_MAX_OFFSET      64                  // Furthest a centre may be from MID_RANGE
+#define JOY_CAL_MIN_SPAN        384                 // Throw assumed on each side of a new centre
+#define JOY_CAL_SAVE_DELTA      4                   // Change (counts) that gets the record rewritten
+
+// Bank 0 information memory holds the boot-override mailbox, TLV and BSL,
+//  bank 1 information memory is free for the application
+#define JOY_CAL_FLASH_ADDR      0x00204000          // Bank 1 information memory, sector 0
+#define JOY_CAL_MAGIC           0x4A43414CUL        // "JCAL"
+
+typedef struct
+{
+    uint16_t centre;            // Reading at rest
+    uint16_t noise;             // Furthest a rest reading was from centre
+    uint16_t lo;                // Lowest reading the axis reaches
+    uint16_t hi;                // Highest reading the axis reaches
+} JoystickCal;
+
+// Calibration in use, indexed by ADC_SAMPLE_X and ADC_SAMPLE_Y
+extern JoystickCal joystickCal[2];
+
+/*!
+ * \brief Loads the stored calibration and applies it to the joystick filters
+ *
+ * Falls back to a centred joystick with JOY_CAL_MIN_SPAN of throw each way
+ *  if flash holds no valid record. Call after configureADC14().
+ *
+ * \return None
+ */
+extern void initJoystickCalibration(void);
+
+/*!
+ * \brief Collects rest readings and recalibrates once a window is steady
+ *
+ * Call on every pass of the main loop while the joystick is not in use.
+ *  Never waits; it only looks at the frames that arrived since the last
+ *  call. Once the calibration has moved by JOY_CAL_SAVE_DELTA or more from
+ *  the record in flash, the record is marked for saveJoystickCalibration().
+ *
+ * \return true if a steady window was found on this call
+ */
+extern bool calibrateJoystick(void);
+
+/*!
+ * \brief Rewrites the record in flash if the calibration has moved
+ *
+ * Stalls the CPU, interrupts included, for the duration of a sector erase.
+ *  Only call with both stepper axes at rest and disarmed, or they would
+ *  lose steps.
+ *
+ * \return true if the record was rewritten
+ */
+extern bool saveJoystickCalibration(void);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JOYSTICKCAL_H_ */
@@ -0,0 +1,134 @@
+/*! \file */
+/*!
+ * joystickFilter.c
+ *
+ * Description: Median, IIR and hysteresis dead-zone filter for one joystick
+ *              axis, using integer math only.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "joystickFilter.h"
+
+/*!
+ * Computes the output gain for a throw of \a span counts from the centre
+ *
+ * \param span Counts from the centre to the extreme
+ *
+ * \return Gain (Q12)
+ */
+static uint32_t sideGain(int32_t span)
+{
+    if (span < JOY_MIN_SPAN)
+    {
+        span = JOY_MIN_SPAN;
+    }
+    return ((uint32_t)JOY_FULL_DEFLECTION << JOY_GAIN_FRAC) / span;
+}
+
+void initJoystickFilter(JoystickFilter *filter, const JoystickFilterConfig *config, uint16_t centre)
+{
+    uint8_t i;
+
+    filter->config = config;
+    setJoystickRange(filter, centre, (centre > JOY_FULL_DEFLECTION) ? centre - JOY_FULL_DEFLECTION : 0,
+                     centre + JOY_FULL_DEFLECTION);
+    for (i = 0; i < JOY_MEDIAN_MAX; i++)
+    {
+        filter->history[i] = centre << JOY_SAMPLE_FRAC;
+    }
+    filter->next = 0;
+    filter->state = (int32_t)centre << JOY_IIR_FRAC;
+    filter->centred = true;
+    filter->deflection = 0;
+}
+
+void setJoystickRange(JoystickFilter *filter, uint16_t centre, uint16_t lo, uint16_t hi)
+{
+    filter->centre = centre;
+    filter->lo = lo;
+    filter->hi = hi;
+    filter->gainLo = sideGain((int32_t)centre - lo);
+    filter->gainHi = sideGain((int32_t)hi - centre);
+}
+
+int16_t filterJoystick(JoystickFilter *filter, uint16_t sample)
+{
+    const JoystickFilterConfig *config = filter->config;
+    uint16_t window[JOY_MEDIAN_MAX];
+    uint16_t value;
+    uint8_t i, j, k;
+    int32_t deflection, magnitude, scaled;
+
+    filter->history[filter->next] = sample;
+    filter->next = (filter->next == JOY_MEDIAN_MAX - 1) ? 0 : filter->next + 1;
+
+    // Median of the latest medianTaps samples by insertion sort, newest first
+    k = filter->next;
+    for (i = 0; i < config->medianTaps; i++)
+    {
+        k = (k == 0) ? JOY_MEDIAN_MAX - 1 : k - 1;
+        value = filter->history[k];
+        for (j = i; j > 0 && window[j - 1] > value; j--)
+        {
+            window[j] = window[j - 1];
+        }
+        window[j] = value;
+    }
+    value = window[config->medianTaps / 2];
+
+    // Single-pole IIR, the state moves 1/2^iirShift of the way to the median
+    filter->state += (((int32_t)value << (JOY_IIR_FRAC - JOY_SAMPLE_FRAC)) - filter->state) >> config->iirShift;
+
+    value = (filter->state + (1 << (JOY_IIR_FRAC - 1))) >> JOY_IIR_FRAC;
+
+    // Widen the throw if the stick goes further than seen so far
+    if (value > filter->hi)
+    {
+        filter->hi = value;
+        filter->gainHi = sideGain((int32_t)value - filter->centre);
+    }
+    else if (value < filter->lo)
+    {
+        filter->lo = value;
+        filter->gainLo = sideGain((int32_t)filter->centre - value);
+    }
+
+    // Deflection at the resolution of the deflection output, so readings
+    //  finer than a count still change the speed
+    deflection = (filter->state - ((int32_t)filter->centre << JOY_IIR_FRAC)) >> (JOY_IIR_FRAC - JOY_DEFLECT_FRAC);
+    magnitude = (deflection < 0) ? -deflection : deflection;
+
+    // Hysteresis: leaving the dead-zone takes more deflection than staying out
+    if (filter->centred)
+    {
+        filter->centred = (magnitude <= (config->exitBand << JOY_DEFLECT_FRAC));
+    }
+    else
+    {
+        filter->centred = (magnitude <= (config->enterBand << JOY_DEFLECT_FRAC));
+    }
+
+    if (filter->centred)
+    {
+        deflection = 0;
+    }
+    else
+    {
+        scaled = (magnitude * ((deflection < 0) ? filter->gainLo : filter->gainHi)) >> JOY_GAIN_FRAC;
+        if (scaled > JOY_FULL_DEFLECTION << JOY_DEFLECT_FRAC)
+        {
+            scaled = JOY_FULL_DEFLECTION << JOY_DEFLECT_FRAC;
+        }
+        // Between the thresholds the axis keeps moving at its slowest speed
+        if (scaled < config->activeBand << JOY_DEFLECT_FRAC)
+        {
+            scaled = config->activeBand << JOY_DEFLECT_FRAC;
+        }
+        deflection = (deflection < 0) ? -scaled : scaled;
+    }
+
+    filter->deflection = deflection;
+    return deflection;
+}
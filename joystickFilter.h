@@ -0,0 +1,121 @@
+/*! \file */
+/*!
+ * joystickFilter.h
+ *
+ * Description: Integer-only filter for one joystick axis, run on every ADC
+ *              frame. A short median removes single-sample spikes, a
+ *              single-pole IIR smooths what is left, and a dead-zone with
+ *              separate enter and exit thresholds keeps the claw from
+ *              flipping between moving and stopped near the centre.
+ *
+ *              Samples carry JOY_SAMPLE_FRAC fractional bits from
+ *              oversampling, which the IIR keeps. The result is a signed
+ *              deflection from the rest position with JOY_DEFLECT_FRAC
+ *              fractional bits, 0 inside the dead-zone and at least
+ *              activeBand outside it. Each side is scaled so that the
+ *              furthest reading seen on it gives JOY_FULL_DEFLECTION, which
+ *              keeps the whole speed range reachable when the rest position
+ *              is off-centre.
+ *              Every call takes the same path apart from the median, which
+ *              sorts at most JOY_MEDIAN_MAX samples, so its cost is bounded.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef JOYSTICKFILTER_H_
+#define JOYSTICKFILTER_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define JOY_MEDIAN_MAX                  5           // Longest median window (samples)
+#define JOY_SAMPLE_FRAC                 3           // Fractional bits of the samples
+#define JOY_IIR_FRAC                    6           // Fractional bits of the IIR state
+#define JOY_DEFLECT_FRAC                4           // Fractional bits of the deflection
+#define JOY_FULL_DEFLECTION             511         // Output at the extremes of the throw (counts)
+#define JOY_MIN_SPAN                    64          // Shortest throw from centre to an extreme
+#define JOY_GAIN_FRAC                   12          // Fractional bits of the side gains
+
+typedef struct
+{
+    uint8_t medianTaps;         // Median window, odd, 1 to JOY_MEDIAN_MAX (1 = off)
+    uint8_t iirShift;           // Weight of a new sample is 1/2^iirShift (0 = off)
+    uint16_t enterBand;         // Deflection at or below which the dead-zone is entered (counts)
+    uint16_t exitBand;          // Deflection above which the dead-zone is left (counts)
+    uint16_t activeBand;        // Smallest deflection reported outside the dead-zone (counts)
+} JoystickFilterConfig;
+
+typedef struct
+{
+    const JoystickFilterConfig *config;
+    uint16_t history[JOY_MEDIAN_MAX];   // Latest raw samples (counts, Q3), oldest overwritten
+    uint8_t next;               // Slot the next sample goes to
+    uint16_t centre;            // Reading at rest (counts)
+    uint16_t lo;                // Lowest filtered reading seen (counts)
+    uint16_t hi;                // Highest filtered reading seen (counts)
+    uint32_t gainLo;            // Output per count below centre (Q12)
+    uint32_t gainHi;            // Output per count above centre (Q12)
+    int32_t state;              // IIR output (counts, Q6)
+    bool centred;               // Inside the dead-zone
+    volatile int16_t deflection;    // Latest filter output (counts, Q4)
+} JoystickFilter;
+
+/*!
+ * \brief Initializes a filter settled at rest
+ *
+ * \param filter Filter state to initialize
+ * \param config Filter settings, kept by reference
+ * \param centre Reading of the axis at rest
+ *
+ * \return None
+ */
+extern void initJoystickFilter(JoystickFilter *filter, const JoystickFilterConfig *config, uint16_t centre);
+
+/*!
+ * \brief Sets the rest position and the extremes of the throw
+ *
+ * The extremes keep widening as the filter sees readings beyond them.
+ *  Throws shorter than JOY_MIN_SPAN are taken as JOY_MIN_SPAN.
+ *  Changes several fields, so not while an interrupt may run the filter.
+ *
+ * \param filter Filter to update
+ * \param centre Reading of the axis at rest
+ * \param lo     Lowest reading the axis reaches
+ * \param hi     Highest reading the axis reaches
+ *
+ * \return None
+ */
+extern void setJoystickRange(JoystickFilter *filter, uint16_t centre, uint16_t lo, uint16_t hi);
+
+/*!
+ * \brief Runs one sample through the filter
+ *
+ * \param filter Filter to update
+ * \param sample ADC reading (counts, Q3)
+ *
+ * \return Deflection from centre (counts, Q4), 0 inside the dead-zone
+ */
+extern int16_t filterJoystick(JoystickFilter *filter, uint16_t sample);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JOYSTICKFILTER_H_ */
@@ -0,0 +1,21 @@
+/*
+ * joystickMap.c
+ *
+ * Description: Joystick reading to stepper direction and period table,
+ *              expanded from the formulas in joystickMap.h at compile time.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "joystickMap.h"
+
+#define JOY_ENTRY(adc)      { JOY_DIR(adc) == JOY_DIR_NONE ? 0 : JOY_PERIOD(adc), JOY_DIR(adc) }
+#define JOY_ROW4(a)         JOY_ENTRY(a), JOY_ENTRY((a) + 1), JOY_ENTRY((a) + 2), JOY_ENTRY((a) + 3)
+#define JOY_ROW16(a)        JOY_ROW4(a), JOY_ROW4((a) + 4), JOY_ROW4((a) + 8), JOY_ROW4((a) + 12)
+#define JOY_ROW64(a)        JOY_ROW16(a), JOY_ROW16((a) + 16), JOY_ROW16((a) + 32), JOY_ROW16((a) + 48)
+#define JOY_ROW256(a)       JOY_ROW64(a), JOY_ROW64((a) + 64), JOY_ROW64((a) + 128), JOY_ROW64((a) + 192)
+
+const JoystickStep joystickMap[JOY_ENTRIES] = {
+    JOY_ROW256(0), JOY_ROW256(256), JOY_ROW256(512), JOY_ROW256(768)
+};
@@ -0,0 +1,80 @@
+/*
+ * joystickMap.h
+ *
+ * Description: Constant table translating a 10-bit joystick reading into a
+ *              direction and stepper period. The table is computed by the
+ *              compiler from the settings below, so changing the dead-zone
+ *              or response curve only needs a rebuild.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef JOYSTICKMAP_H_
+#define JOYSTICKMAP_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "adc.h"
+#include "stepperMotor.h"
+
+#define JOY_ENTRIES         (MAX_VAL + 1)           // One entry per 10-bit reading
+#define JOY_DEAD_LO         (MID_RANGE - REST_ERROR) // Readings below move towards -1
+#define JOY_DEAD_HI         (MID_RANGE + REST_ERROR) // Readings above move towards +1
+
+/* Response curve: 0 is linear, JOY_SCALE is a pure cubic (expo). Values in
+ * between blend the two, giving finer control near the centre.
+ */
+#define JOY_SCALE           1024
+#define JOY_EXPO            0
+
+#define JOY_DIR_NEG         (-1)
+#define JOY_DIR_NONE        0
+#define JOY_DIR_POS         1
+
+/* Deflection past the dead-zone edge, scaled to 0..JOY_SCALE */
+#define JOY_DEFLECT(adc)    ((adc) < JOY_DEAD_LO \
+                                ? (JOY_DEAD_LO - 1 - (adc)) * JOY_SCALE / (JOY_DEAD_LO - 1) \
+                                : ((adc) - JOY_DEAD_HI - 1) * JOY_SCALE / (MAX_VAL - JOY_DEAD_HI - 1))
+
+/* Deflection after the response curve, 0..JOY_SCALE */
+#define JOY_CURVE(n)        (((n) * (JOY_SCALE - JOY_EXPO) \
+                                + (n) * (n) / JOY_SCALE * (n) / JOY_SCALE * JOY_EXPO) / JOY_SCALE)
+
+/* Speed in RPM * JOY_SCALE, MIN_RPM at the dead-zone edge up to MAX_RPM */
+#define JOY_RPM_Q(adc)      (MIN_RPM * JOY_SCALE + (MAX_RPM - MIN_RPM) * JOY_CURVE(JOY_DEFLECT(adc)))
+
+#define JOY_PERIOD(adc)     ((uint16_t)(1ULL * CLK_RATE * SEC_PER_MIN * JOY_SCALE \
+                                / (1ULL * JOY_RPM_Q(adc) * STEPS_PER_REV)))
+
+#define JOY_DIR(adc)        ((adc) < JOY_DEAD_LO ? JOY_DIR_NEG \
+                                : (adc) > JOY_DEAD_HI ? JOY_DIR_POS : JOY_DIR_NONE)
+
+typedef struct
+{
+    uint16_t period;        // Step period in timer ticks, 0 inside the dead-zone
+    int8_t dir;             // JOY_DIR_NEG, JOY_DIR_NONE or JOY_DIR_POS
+} JoystickStep;
+
+extern const JoystickStep joystickMap[JOY_ENTRIES];
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* JOYSTICKMAP_H_ */
@@ -8,30 +8,83 @@
  *                            R/W --->GND
  *                P4  <-----> DB
  *
- *          This module uses SysTick timer for delays.
+ *          This module uses the SysTick interrupt to clock out the queued
+ *          nibbles, see lcd.h.
  *
  *      Author: Vineet Ranade & Yao Xiong
  */
 
 #include <msp.h>
 
+#include <string.h>
+
 #include "lcd.h"
-#include "sysTickDelays.h"
+#include "gpio.h"
 
 #define NONHOME_MASK        0xFC
 
-#define LONG_INSTR_DELAY    2000
+#define LCD_STROBE_US       1           // E high time
+#define LCD_NIBBLE_DELAY    2           // E low time between two nibbles
 #define SHORT_INSTR_DELAY   50
+#define LONG_INSTR_DELAY    2000
+#define POWER_INSTR_DELAY   5000        // After the first power-on function set
+#define POWER_ON_DELAY      40000       // From power-on to the first instruction
+
+// Queued nibble: DB7-DB4 in the upper bits as they go to LCD_DB_PORT, RS,
+//  and what to wait for after E falls
+#define LCD_OP_DATA_MASK    0xF0
+#define LCD_OP_RS           0x04
+#define LCD_OP_WAIT_MASK    0x03
+#define LCD_WAIT_NIBBLE     0           // Between the nibbles of one instruction
+#define LCD_WAIT_SHORT      1           // After most instructions and all data
+#define LCD_WAIT_LONG       2           // After Clear Display and Return Home
+#define LCD_WAIT_POWER      3           // During the power-on function sets
+
+#define US_PER_SECOND       1000000
+
+#define LCD_CURSOR_UNKNOWN  0xFF        // Cursor off the visible spots or not tracked
+#define LCD_BRIDGE_GAP      1           // Unchanged spots rewritten rather than skipped
+
+static uint8_t lcdQueue[LCD_QUEUE_SIZE];
+static volatile uint8_t lcdHead;        // Nibbles queued, written by the main loop
+static uint8_t lcdFill;                 // Nibbles written, lcdHead once published
+static volatile uint8_t lcdTail;        // Nibbles sent, written by the ISR
+static volatile bool lcdBusy;           // SysTick is running the queue
+static bool lcdStrobe;                  // E is high
+static uint8_t lcdWait;                 // LCD_WAIT_x of the nibble being sent
+
+// SysTick ticks of the E pulse and of each LCD_WAIT_x
+static uint32_t lcdStrobeTicks;
+static uint32_t lcdWaitTicks[4];
+static uint32_t lcdPowerOnTicks;
+
+// Bit-band aliases of RS and E, since P5 also carries the servo and the
+//  photoresistors
+static volatile uint32_t *lcdRsBit;
+static volatile uint32_t *lcdEnBit;
+
+// Spots as they will be once the queue is sent, and the cursor then
+static char lcdShadow[NUM_SPOTS];
+static uint8_t lcdCursor;
+
+LcdStats lcdStats;
+
+#ifdef LCD_BENCHMARK
+uint32_t lcdUpdateTicks;
+uint32_t lcdUpdateMaxTicks;
+#endif
 
 void setupLCD()
 {
-    // configures pins and delay library
+    // configures pins and wait times
     configLCD(CLK_FREQUENCY);
-    // sends initialization sequence and configuration to LCD
+    // queues initialization sequence and configuration for the LCD
     initLCD();
 }
 
 void configLCD(uint32_t clkFreq) {
+    uint32_t ticksPerUs = clkFreq / US_PER_SECOND;
+
     // configure pins as GPIO
     LCD_DB_PORT->SEL0 = 0;
     LCD_DB_PORT->SEL1 = 0;
@@ -46,78 +99,146 @@ void configLCD(uint32_t clkFreq) {
     LCD_RS_PORT->DIR |= LCD_RS_MASK;
     LCD_EN_PORT->DIR |= LCD_EN_MASK;
 
-    initDelayTimer(clkFreq);
+    lcdRsBit = gpioBitAlias(&LCD_RS_PORT->OUT, LCD_RS_BIT);
+    lcdEnBit = gpioBitAlias(&LCD_EN_PORT->OUT, LCD_EN_BIT);
+
+    // Execution times from Table 6 of HD44780 data sheet, with buffer
+    lcdStrobeTicks = LCD_STROBE_US * ticksPerUs;
+    lcdWaitTicks[LCD_WAIT_NIBBLE] = LCD_NIBBLE_DELAY * ticksPerUs;
+    lcdWaitTicks[LCD_WAIT_SHORT] = SHORT_INSTR_DELAY * ticksPerUs;
+    lcdWaitTicks[LCD_WAIT_LONG] = LONG_INSTR_DELAY * ticksPerUs;
+    lcdWaitTicks[LCD_WAIT_POWER] = POWER_INSTR_DELAY * ticksPerUs;
+    lcdPowerOnTicks = POWER_ON_DELAY * ticksPerUs;
+
+    lcdHead = 0;
+    lcdFill = 0;
+    lcdTail = 0;
+    lcdBusy = false;
+    lcdStrobe = false;
+}
+
+/*!
+ * Restarts SysTick to interrupt after \a ticks
+ *
+ * \param ticks SysTick ticks (MCLK), 2 to 2^24
+ *
+ * \return None
+ */
+static void lcdTimer(uint32_t ticks)
+{
+    SysTick->LOAD = ticks - 1;
+    // Write any value to reset timer counter
+    SysTick->VAL = 0;
 }
 
 /*!
- * Delay method based on instruction execution time.
- *   Execution times from Table 6 of HD44780 data sheet, with buffer.
+ * Starts clocking out the queue, unless it is already running
  *
- * \param mode RS mode selection
- * \param instruction Instruction/data to write to LCD
+ * \param ticks SysTick ticks before the first nibble
  *
  * \return None
  */
-void instructionDelay(uint8_t mode, uint8_t instruction) {
+static void startQueue(uint32_t ticks)
+{
+    // Once lcdBusy is false the ISR has stopped for good, so it cannot
+    //  interfere here
+    if (!lcdBusy)
+    {
+        lcdBusy = true;
+        lcdTimer(ticks);
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+}
+
+/*!
+ * Counts the free nibbles of the queue
+ *
+ * \return Nibbles that can be queued
+ */
+static uint8_t queueFree(void)
+{
+    return LCD_QUEUE_SIZE - (uint8_t)(lcdFill - lcdTail);
+}
+
+/*!
+ * Writes one nibble behind the queue; the caller checks for room and
+ *  publishes it with publishQueue()
+ *
+ * \param mode   RS mode selection
+ * \param nibble Value for DB7-DB4, in the upper four bits
+ * \param wait   LCD_WAIT_x after the nibble
+ *
+ * \return None
+ */
+static void queueNibble(uint8_t mode, uint8_t nibble, uint8_t wait)
+{
+    lcdQueue[lcdFill & (LCD_QUEUE_SIZE - 1)] = (nibble & LCD_OP_DATA_MASK)
+                                              | ((mode == DATA_MODE) ? LCD_OP_RS : 0) | wait;
+    lcdFill++;
+}
+
+/*!
+ * Hands the nibbles written so far to the ISR and makes sure it runs
+ *
+ * \param ticks SysTick ticks before the first nibble, if the ISR is idle
+ *
+ * \return None
+ */
+static void publishQueue(uint32_t ticks)
+{
+    // The ISR only sees the nibbles once they are all written
+    __DMB();
+    lcdHead = lcdFill;
+    startQueue(ticks);
+}
+
+/*!
+ * Writes an instruction/data write behind the queue, see queueNibble()
+ *
+ * \param mode          Write mode: 0 - control, 1 - data
+ * \param instruction   Instruction/data to write to LCD
+ * \param bits          FOUR_BIT for two nibbles, EIGHT_BIT for the upper one
+ *                      only, as during power-on
+ *
+ * \return None
+ */
+static void queueInstruction(uint8_t mode, uint8_t instruction, uint8_t bits) {
+    uint8_t wait;
+
     // if instruction is Return Home or Clear Display, use long delay for
     //  instruction execution; otherwise, use short delay
     if ((mode == DATA_MODE) || (instruction & NONHOME_MASK)) {
-        delayMicroSec(SHORT_INSTR_DELAY);
+        wait = LCD_WAIT_SHORT;
     }
     else {
-        delayMicroSec(LONG_INSTR_DELAY);
+        wait = LCD_WAIT_LONG;
+    }
+
+    if (bits == FOUR_BIT)
+    {
+        queueNibble(mode, instruction, LCD_WAIT_NIBBLE);
+        queueNibble(mode, instruction << 4, wait);
+    }
+    else
+    {
+        queueNibble(mode, instruction, wait);
     }
 }
 
 /*!
  * Function to write instruction/data to LCD.
  *
+ * Waits only while the queue is full.
+ *
  * \param mode          Write mode: 0 - control, 1 - data
  * \param instruction   Instruction/data to write to LCD
  *
  * \return None
  */
 void writeInstruction(uint8_t mode, uint8_t instruction, uint8_t bits) {
-    // TODO set 8-bit data on LCD DB port
-    LCD_DB_PORT->OUT = instruction;
-
-    // TODO set RS for data or control instruction mode
-    //      use bit-masking to avoid affecting other pins of port
-    if (mode == DATA_MODE) {
-        LCD_RS_PORT->OUT |= LCD_RS_MASK;
-    } else {
-        LCD_RS_PORT->OUT &= ~LCD_RS_MASK;
-    }
-    // pulse E to execute instruction on LCD
-    // TODO set Enable signal high
-    //      use bit-masking to avoid affecting other pins of port
-    LCD_EN_PORT->OUT |= LCD_EN_MASK;
-
-    delayMicroSec(1);
-    // TODO set Enable signal low
-    //      use bit-masking to avoid affecting other pins of port
-    LCD_EN_PORT->OUT &= ~LCD_EN_MASK;
-
-    // delay to allow instruction execution to complete
-    instructionDelay(mode, instruction);
-
-    if (bits == FOUR_BIT)
-    {
-        LCD_DB_PORT->OUT = instruction << 4;
-
-        // pulse E to execute instruction on LCD
-        // TODO set Enable signal high
-        //      use bit-masking to avoid affecting other pins of port
-        LCD_EN_PORT->OUT |= LCD_EN_MASK;
-
-        delayMicroSec(1);
-        // TODO set Enable signal low
-        //      use bit-masking to avoid affecting other pins of port
-        LCD_EN_PORT->OUT &= ~LCD_EN_MASK;
-
-        // delay to allow instruction execution to complete
-        instructionDelay(mode, instruction);
-    }
+    while (queueFree() < 2);
+    queueInstruction(mode, instruction, bits);
+    publishQueue(lcdWaitTicks[LCD_WAIT_NIBBLE]);
 }
 
 /*!
@@ -145,35 +266,53 @@ void dataInstruction(uint8_t data) {
 
 void initLCD(void) {
     // follows initialization sequence described for 4-bit data mode in
-    //  Figure 24 of HD447780 data sheet
-    delayMilliSec(40);
-    commandInstruction(FUNCTION_SET_MASK | DL_FLAG_MASK, EIGHT_BIT);
-    delayMilliSec(5);
-    commandInstruction(FUNCTION_SET_MASK | DL_FLAG_MASK, EIGHT_BIT);
-    delayMicroSec(150);
-    commandInstruction(FUNCTION_SET_MASK | DL_FLAG_MASK, EIGHT_BIT);
-    delayMicroSec(SHORT_INSTR_DELAY);
-    commandInstruction(FUNCTION_SET_MASK, EIGHT_BIT);
-    delayMicroSec(SHORT_INSTR_DELAY);
-    commandInstruction(FUNCTION_SET_MASK | N_FLAG_MASK, FOUR_BIT);
-    delayMicroSec(SHORT_INSTR_DELAY);
-    commandInstruction(CLEAR_DISPLAY_MASK, FOUR_BIT);
-    delayMicroSec(SHORT_INSTR_DELAY);
-    commandInstruction(ENTRY_MODE_MASK | ID_FLAG_MASK, FOUR_BIT);
-    delayMicroSec(LONG_INSTR_DELAY);
+    //  Figure 24 of HD447780 data sheet, starting after the power-on wait
+    queueNibble(CTRL_MODE, FUNCTION_SET_MASK | DL_FLAG_MASK, LCD_WAIT_POWER);
+    queueNibble(CTRL_MODE, FUNCTION_SET_MASK | DL_FLAG_MASK, LCD_WAIT_LONG);
+    queueNibble(CTRL_MODE, FUNCTION_SET_MASK | DL_FLAG_MASK, LCD_WAIT_SHORT);
+    queueNibble(CTRL_MODE, FUNCTION_SET_MASK, LCD_WAIT_SHORT);
+    queueInstruction(CTRL_MODE, FUNCTION_SET_MASK | N_FLAG_MASK, FOUR_BIT);
+    queueInstruction(CTRL_MODE, CLEAR_DISPLAY_MASK, FOUR_BIT);
+    queueInstruction(CTRL_MODE, ENTRY_MODE_MASK | ID_FLAG_MASK, FOUR_BIT);
 
     // after initialization and configuration, turn display ON
-    commandInstruction(DISPLAY_CTRL_MASK | D_FLAG_MASK, FOUR_BIT);
+    queueInstruction(CTRL_MODE, DISPLAY_CTRL_MASK | D_FLAG_MASK, FOUR_BIT);
+
+    // Clear Display blanks every spot and homes the cursor
+    memset(lcdShadow, ' ', NUM_SPOTS);
+    lcdCursor = 0;
+
+    publishQueue(lcdPowerOnTicks);
+}
+
+/*!
+ * Cursor spot after a character is written at \a spot
+ *
+ * \param spot Spot written, 0 to NUM_SPOTS - 1
+ *
+ * \return Next spot, or LCD_CURSOR_UNKNOWN past the end of a line
+ */
+static uint8_t nextSpot(uint8_t spot)
+{
+    spot++;
+    return (spot == NUM_PER_LINE || spot == NUM_SPOTS) ? LCD_CURSOR_UNKNOWN : spot;
 }
 
 void printChar(char character) {
     // print ASCII \b character to current cursor position
     dataInstruction(character);
+    if (lcdCursor != LCD_CURSOR_UNKNOWN)
+    {
+        lcdShadow[lcdCursor] = character;
+        lcdCursor = nextSpot(lcdCursor);
+    }
 }
 
 void clearDisplay() {
     // clear the LCD display and return cursor to home position
     commandInstruction(CLEAR_DISPLAY_MASK, FOUR_BIT);
+    memset(lcdShadow, ' ', NUM_SPOTS);
+    lcdCursor = 0;
 }
 
 void returnHome() {
@@ -181,37 +320,172 @@ void returnHome() {
     moveCursor(LINE1_START_POS);
 }
 
-void moveCursor(uint8_t pos)
+/*!
+ * Set DDRAM address instruction for a cursor position
+ *
+ * \param pos from 1-32
+ *
+ * \return Instruction
+ */
+static uint8_t cursorInstruction(uint8_t pos)
 {
     // Set DDRAM address (non-continuous address space from Line 1 to 2)
     if (pos < LINE2_START_POS)
     {
-        commandInstruction(SET_CURSOR_MASK | (LINE1_OFFSET + (pos - LINE1_START_POS)), FOUR_BIT);
-    }
-    else
-    {
-        commandInstruction(SET_CURSOR_MASK | (LINE2_OFFSET + (pos - LINE2_START_POS)), FOUR_BIT);
+        return SET_CURSOR_MASK | (LINE1_OFFSET + (pos - LINE1_START_POS));
     }
+    return SET_CURSOR_MASK | (LINE2_OFFSET + (pos - LINE2_START_POS));
 }
 
-void updateDispVal(char* str)
+void moveCursor(uint8_t pos)
 {
-    moveCursor(LINE1_START_POS);
-    for (i = 0; i < NUM_SPOTS && str[i] != '\0'; i++)
+    commandInstruction(cursorInstruction(pos), FOUR_BIT);
+    lcdCursor = pos - LINE1_START_POS;
+}
+
+/*!
+ * Plans the writes that turn the shadow into \a text, and queues them
+ *
+ * Only changed spots are written. The cursor is moved only where the
+ *  auto-increment does not already lead to the next changed spot, except
+ *  across a gap of up to LCD_BRIDGE_GAP unchanged spots on the same line,
+ *  which are rewritten instead: the same number of instructions, with one
+ *  cursor move less.
+ *
+ * \param text NUM_SPOTS characters to show
+ * \param emit false to only count the instructions, true to also queue
+ *             them and update the shadow
+ *
+ * \return LCD instructions needed
+ */
+static uint8_t renderText(const char *text, bool emit)
+{
+    uint8_t spot, cursor = lcdCursor, count = 0;
+
+    for (spot = 0; spot < NUM_SPOTS; spot++)
     {
-        if (i == NUM_PER_LINE)
+        if (text[spot] == lcdShadow[spot])
         {
-            moveCursor(LINE2_START_POS);
+            continue;
         }
-        printChar(str[i]);
-    }
-    while (i < NUM_SPOTS)
-    {
-        if (i == NUM_PER_LINE)
+
+        if (cursor != LCD_CURSOR_UNKNOWN && cursor < spot && spot - cursor <= LCD_BRIDGE_GAP
+            && cursor / NUM_PER_LINE == spot / NUM_PER_LINE)
         {
-            moveCursor(LINE2_START_POS);
+            for (; cursor < spot; cursor++)
+            {
+                if (emit)
+                {
+                    queueInstruction(DATA_MODE, text[cursor], FOUR_BIT);
+                }
+                count++;
+            }
         }
-        printChar(' ');
-        i++;
+        else if (cursor != spot)
+        {
+            if (emit)
+            {
+                queueInstruction(CTRL_MODE, cursorInstruction(spot + LINE1_START_POS), FOUR_BIT);
+            }
+            count++;
+        }
+
+        if (emit)
+        {
+            queueInstruction(DATA_MODE, text[spot], FOUR_BIT);
+            lcdShadow[spot] = text[spot];
+        }
+        count++;
+        cursor = nextSpot(spot);
+    }
+
+    if (emit)
+    {
+        lcdCursor = cursor;
+    }
+    return count;
+}
+
+bool updateDispVal(char* str)
+{
+    char text[NUM_SPOTS];
+    uint8_t i, count;
+#ifdef LCD_BENCHMARK
+    uint32_t start = readTimestamp();
+#endif
+
+    // Pad with spaces after the end of the string
+    for (i = 0; i < NUM_SPOTS; i++)
+    {
+        text[i] = (*str != '\0') ? *str++ : ' ';
     }
+
+    // All of the changes or nothing at all
+    count = renderText(text, false);
+    if (queueFree() < 2 * count)
+    {
+        return false;
+    }
+    if (count != 0)
+    {
+        renderText(text, true);
+        publishQueue(lcdWaitTicks[LCD_WAIT_NIBBLE]);
+    }
+
+    lcdStats.frames++;
+    lcdStats.instructions += count;
+    lcdStats.lastFrame = count;
+    if (count > lcdStats.maxFrame)
+    {
+        lcdStats.maxFrame = count;
+    }
+
+#ifdef LCD_BENCHMARK
+    lcdUpdateTicks = readTimestamp() - start;
+    if (lcdUpdateTicks > lcdUpdateMaxTicks)
+    {
+        lcdUpdateMaxTicks = lcdUpdateTicks;
+    }
+#endif
+    return true;
+}
+
+/*!
+ * \brief SysTick interrupt service routine
+ *
+ * Sends one nibble in two steps: the first puts it on DB with RS and
+ *  raises E, the second lowers E and waits as long as the nibble needs
+ *  before the next one. Stops SysTick once the queue is empty.
+ *
+ * \return None
+ */
+void SysTick_Handler(void)
+{
+    uint8_t op;
+
+    if (lcdStrobe)
+    {
+        // LCD latches DB on the falling edge
+        *lcdEnBit = 0;
+        lcdStrobe = false;
+        lcdTimer(lcdWaitTicks[lcdWait]);
+        return;
+    }
+
+    if (lcdTail == lcdHead)
+    {
+        SysTick->CTRL = 0;
+        lcdBusy = false;
+        return;
+    }
+
+    op = lcdQueue[lcdTail & (LCD_QUEUE_SIZE - 1)];
+    lcdTail++;
+
+    LCD_DB_PORT->OUT = op & LCD_OP_DATA_MASK;
+    *lcdRsBit = (op & LCD_OP_RS) ? 1 : 0;
+    *lcdEnBit = 1;
+    lcdWait = op & LCD_OP_WAIT_MASK;
+    lcdStrobe = true;
+    lcdTimer(lcdStrobeTicks);
 }
@@ -8,7 +8,11 @@
  *                            R/W --->GND
  *                P4  <-----> DB
  *
- *          This module uses SysTick timer for delays.
+ *          Writes are queued as nibbles and clocked out by the SysTick
+ *          interrupt with each instruction's execution time in between,
+ *          so the functions below only wait, if at all, for room in the
+ *          queue. This module owns SysTick, so sysTickDelays cannot be
+ *          used alongside it.
  *
  *      Author: Vineet Ranade & Yao Xiong
  */
@@ -28,12 +32,20 @@ extern "C"
 #endif
 
 #include <msp.h>
+#include <stdbool.h>
+#ifdef LCD_BENCHMARK
+#include <timer32.h>
+#endif
 
 #define LCD_DB_PORT         P4
 #define LCD_RS_PORT         P5
 #define LCD_EN_PORT         P5
 #define LCD_RS_MASK         BIT7
 #define LCD_EN_MASK         BIT5
+#define LCD_RS_BIT          7
+#define LCD_EN_BIT          5
+
+#define LCD_QUEUE_SIZE      128         // Nibbles, power of two up to 128, more than a repaint
 
 #define CTRL_MODE           0
 #define DATA_MODE           1
@@ -97,7 +109,22 @@ extern "C"
 
 #define ASCII_OFFSET      48
 
-volatile uint32_t i;
+typedef struct
+{
+    uint32_t frames;            // updateDispVal() calls that returned true
+    uint32_t instructions;      // LCD instructions they emitted
+    uint8_t lastFrame;          // Instructions of the latest one, 0 if unchanged
+    uint8_t maxFrame;           // Instructions of the largest one
+} LcdStats;
+
+extern LcdStats lcdStats;
+
+#ifdef LCD_BENCHMARK
+// The main loop stall per repaint. Read lcdUpdateMaxTicks in the debugger
+//  after a few rounds, dividing by TIMESTAMP_RATE / 1000000 for microseconds.
+extern uint32_t lcdUpdateTicks;         // Time the last updateDispVal() took, in TIMESTAMP_RATE ticks
+extern uint32_t lcdUpdateMaxTicks;      // and the longest so far
+#endif
 
 /*!
  *
@@ -114,8 +141,8 @@ extern void setupLCD(void);
  *  \brief This function configures the selected pins for an LCD
  *
  *  This function configures the selected pins as output pins to interface
- *      with a Hitachi HD44780 LCD in 8-bit mode. Also initializes sysTickDelay
- *      library based on system clock frequency.
+ *      with a Hitachi HD44780 LCD in 4-bit mode. Also converts the LCD wait
+ *      times to SysTick ticks based on system clock frequency.
  *
  *  \param clkFreq is the frequency of the system clock (MCLK) in Hz
  *
@@ -129,8 +156,9 @@ extern void configLCD(uint32_t clkFreq);
 /*!
  *  \brief This function initializes LCD
  *
- *  This function generates initialization sequence for LCD for 8-bit mode.
- *      Delays set by worst-case 2.7 V
+ *  This function queues the initialization sequence for LCD for 4-bit mode,
+ *      which starts once interrupts are enabled. Delays set by worst-case
+ *      2.7 V
  *
  *  \return None
  */
@@ -169,14 +197,29 @@ extern void clearDisplay(void);
  */
 extern void returnHome();
 
-extern void updateDispVal(char* str);
+/*!
+ *  \brief This function queues the changes to the display.
+ *
+ *  Shows the first 32 characters of a string over both lines, padded with
+ *      spaces. Compares them with a shadow of the display and queues only
+ *      the characters that differ, with the cursor moves they need, so an
+ *      unchanged string costs no LCD instructions. Returns as soon as the
+ *      changes are queued, without waiting for the LCD. Call again later if
+ *      it returns false.
+ *
+ *  \param  str String to show
+ *
+ *  \return true if queued, false if the queue had no room for all of the
+ *      changes
+ */
+extern bool updateDispVal(char* str);
 
 /*!
  *  \brief This function moves cursor.
  *
  *  This function utilizes the set cursor mask
  *
- *  \param  pos from 1-16
+ *  \param  pos from 1-32
  *
  *  \return None
  */
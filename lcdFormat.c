@@ -0,0 +1,77 @@
+/*! \file */
+/*!
+ * lcdFormat.c
+ *
+ * Description: Fixed-width LCD text from strings and integers, without
+ *              sprintf().
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "lcdFormat.h"
+
+uint8_t clearLine(char *line)
+{
+    uint8_t i;
+
+    for (i = 0; i < NUM_SPOTS; i++)
+    {
+        line[i] = ' ';
+    }
+    line[NUM_SPOTS] = '\0';
+    return 0;
+}
+
+uint8_t putText(char *line, uint8_t pos, const char *text)
+{
+    while (pos < NUM_SPOTS && *text != '\0')
+    {
+        line[pos++] = *text++;
+    }
+    return pos;
+}
+
+uint8_t putInt(char *line, uint8_t pos, int32_t value, uint8_t width)
+{
+    uint32_t magnitude = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+    uint8_t end, i;
+
+    if (pos >= NUM_SPOTS || width == 0)
+    {
+        return (pos > NUM_SPOTS) ? NUM_SPOTS : pos;
+    }
+    end = (width > NUM_SPOTS - pos) ? NUM_SPOTS : pos + width;
+
+    // Digits from the right, at least one
+    i = end;
+    do
+    {
+        line[--i] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0 && i > pos);
+
+    if (value < 0 && i > pos)
+    {
+        line[--i] = '-';
+    }
+    else if (value < 0)
+    {
+        magnitude = 1;      // No room for the sign
+    }
+
+    if (magnitude != 0)
+    {
+        for (i = pos; i < end; i++)
+        {
+            line[i] = LCD_OVERFLOW_CHAR;
+        }
+        return end;
+    }
+
+    while (i > pos)
+    {
+        line[--i] = ' ';
+    }
+    return end;
+}
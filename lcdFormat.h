@@ -0,0 +1,84 @@
+/*! \file */
+/*!
+ * lcdFormat.h
+ *
+ * Description: Builds the text of the LCD in a fixed-width line buffer
+ *              from fixed strings and right-aligned integers, instead of
+ *              sprintf(). No varargs and no floating point, so none of the
+ *              printf machinery is linked in. Every function takes the
+ *              position to write at and returns the position after what it
+ *              wrote, and nothing is written past NUM_SPOTS.
+ *
+ *              To size the saving, compare _printfi and its helpers in the
+ *              map file of a build before and after, and time a message
+ *              with readCycleCounter() around its putText()/putInt() calls.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef LCDFORMAT_H_
+#define LCDFORMAT_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include "lcd.h"
+
+#define LCD_LINE_SIZE       (NUM_SPOTS + 1)     // Line buffer size, with the terminator
+#define LCD_OVERFLOW_CHAR   '*'                 // Fills a number too wide for its field
+
+/*!
+ * \brief Blanks a line buffer
+ *
+ * \param line Buffer of LCD_LINE_SIZE characters
+ *
+ * \return 0, the start of the line
+ */
+extern uint8_t clearLine(char *line);
+
+/*!
+ * \brief Writes a fixed string into a line buffer
+ *
+ * \param line Buffer of LCD_LINE_SIZE characters
+ * \param pos  Position to start at
+ * \param text String to copy, without its terminator
+ *
+ * \return Position after the string, at most NUM_SPOTS
+ */
+extern uint8_t putText(char *line, uint8_t pos, const char *text);
+
+/*!
+ * \brief Writes an integer right-aligned in a field of a line buffer
+ *
+ * Padded with spaces on the left. A value that does not fit fills the
+ *  field with LCD_OVERFLOW_CHAR, so the field never grows.
+ *
+ * \param line  Buffer of LCD_LINE_SIZE characters
+ * \param pos   Position of the field
+ * \param value Value to write, with a '-' if negative
+ * \param width Characters in the field
+ *
+ * \return Position after the field, at most NUM_SPOTS
+ */
+extern uint8_t putInt(char *line, uint8_t pos, int32_t value, uint8_t width);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LCDFORMAT_H_ */
@@ -22,9 +22,11 @@ extern "C"
 #endif
 
 #include <msp.h>
+#include "gpio.h"
 
 #define RGB_PORT            P2          // Port 2
 #define RGB_RED_PIN         0b00000001  // P2.0
+#define RGB_RED_BIT         0           // Bit number of RGB_RED_PIN
 
 /*!
  * Initializes Red LED. It will toggle on and off with each press of the joystick
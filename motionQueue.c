@@ -0,0 +1,95 @@
+/*! \file */
+/*!
+ * motionQueue.c
+ *
+ * Description: Lock-free single-producer/single-consumer ring buffer of
+ *              motion segments. A segment is always written completely
+ *              before head moves past it, and read completely before tail
+ *              moves past it, so a single byte store publishes it. Memory
+ *              barriers keep the slot accesses on their side of those
+ *              stores.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "motionQueue.h"
+
+#if (MOTION_QUEUE_SIZE & (MOTION_QUEUE_SIZE - 1)) != 0
+#error "MOTION_QUEUE_SIZE must be a power of two"
+#endif
+
+void initMotionQueue(MotionQueue *queue)
+{
+    queue->head = 0;
+    queue->tail = 0;
+    queue->discardTo = 0;
+    queue->discard = false;
+}
+
+bool pushMotionSegment(MotionQueue *queue, int8_t direction, uint32_t period, uint32_t steps)
+{
+    uint8_t head = queue->head;
+    MotionSegment *segment;
+
+    if ((uint8_t)(head - queue->tail) >= MOTION_QUEUE_SIZE)
+    {
+        return false;
+    }
+    // The consumer is done with the slot before tail moved past it
+    __DMB();
+
+    segment = &queue->segments[head & (MOTION_QUEUE_SIZE - 1)];
+    segment->direction = direction;
+    segment->period = period;
+    segment->steps = steps;
+
+    // Publish the segment only once it is complete
+    __DMB();
+    queue->head = head + 1;
+    return true;
+}
+
+void discardMotionSegments(MotionQueue *queue)
+{
+    // Position first, so the consumer never sees the request without it
+    queue->discardTo = queue->head;
+    __DMB();
+    queue->discard = true;
+}
+
+bool applyMotionDiscard(MotionQueue *queue)
+{
+    if (!queue->discard)
+    {
+        return false;
+    }
+    __DMB();
+    queue->discard = false;
+    queue->tail = queue->discardTo;
+    return true;
+}
+
+bool popMotionSegment(MotionQueue *queue, MotionSegment *segment)
+{
+    uint8_t tail = queue->tail;
+
+    if (tail == queue->head)
+    {
+        return false;
+    }
+    // The segment was complete before head moved past it
+    __DMB();
+
+    *segment = queue->segments[tail & (MOTION_QUEUE_SIZE - 1)];
+
+    // Hand the slot back to the producer only after it has been copied
+    __DMB();
+    queue->tail = tail + 1;
+    return true;
+}
+
+uint8_t motionSegmentsQueued(const MotionQueue *queue)
+{
+    return (uint8_t)(queue->head - queue->tail);
+}
@@ -0,0 +1,124 @@
+/*! \file */
+/*!
+ * motionQueue.h
+ *
+ * Description: Lock-free single-producer/single-consumer ring buffer of
+ *              motion segments. The main loop pushes segments and the step
+ *              interrupt pops them at segment boundaries, so neither side
+ *              ever has to disable interrupts.
+ *
+ *              Only the producer writes head and only the consumer writes
+ *              tail. Both are free-running counters, so head - tail is the
+ *              number of queued segments even after they wrap.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef MOTIONQUEUE_H_
+#define MOTIONQUEUE_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MOTION_QUEUE_SIZE               8       // Segments per queue, power of two
+
+typedef struct
+{
+    uint32_t steps;                 // Half-steps to take before the next segment
+    uint32_t period;                // Target time per half-step (ticks), 0 = stop
+    int8_t direction;               // CW_DIR or CCW_DIR
+} MotionSegment;
+
+typedef struct
+{
+    MotionSegment segments[MOTION_QUEUE_SIZE];
+    volatile uint8_t head;          // Segments pushed, written by the producer
+    volatile uint8_t tail;          // Segments popped, written by the consumer
+    volatile uint8_t discardTo;     // head when the producer asked to discard
+    volatile bool discard;          // Discard request waiting for the consumer
+} MotionQueue;
+
+/*!
+ * \brief Empties a queue, before either side uses it
+ *
+ * \param queue Queue to initialize
+ *
+ * \return None
+ */
+extern void initMotionQueue(MotionQueue *queue);
+
+/*!
+ * \brief Appends a segment to the queue (producer only)
+ *
+ * \param queue     Queue to append to
+ * \param direction CW_DIR or CCW_DIR
+ * \param period    Target time per half-step in timer ticks, 0 to stop
+ * \param steps     Half-steps before the next segment starts
+ *
+ * \return false if the queue is full and the segment was dropped
+ */
+extern bool pushMotionSegment(MotionQueue *queue, int8_t direction, uint32_t period, uint32_t steps);
+
+/*!
+ * \brief Asks the consumer to drop every segment pushed so far (producer only)
+ *
+ * The segments are dropped the next time the consumer calls
+ *  applyMotionDiscard(). Segments pushed after this call are kept.
+ *
+ * \param queue Queue to discard
+ *
+ * \return None
+ */
+extern void discardMotionSegments(MotionQueue *queue);
+
+/*!
+ * \brief Carries out a pending discard request (consumer only)
+ *
+ * \param queue Queue to check
+ *
+ * \return true if segments were discarded, including the one in progress
+ */
+extern bool applyMotionDiscard(MotionQueue *queue);
+
+/*!
+ * \brief Removes the oldest segment from the queue (consumer only)
+ *
+ * \param queue   Queue to pop from
+ * \param segment Receives the segment
+ *
+ * \return false if the queue is empty
+ */
+extern bool popMotionSegment(MotionQueue *queue, MotionSegment *segment);
+
+/*!
+ * \brief Counts the segments waiting in a queue (either side)
+ *
+ * \param queue Queue to check
+ *
+ * \return Number of queued segments
+ */
+extern uint8_t motionSegmentsQueued(const MotionQueue *queue);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MOTIONQUEUE_H_ */
@@ -0,0 +1,102 @@
+/*! \file */
+/*!
+ * photoSensor.c
+ *
+ * Description: Ambient-light tracking and confirmed dark detection for one
+ *              photoresistor, using integer math only.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "photoSensor.h"
+
+/*!
+ * Derives the trigger threshold from the learned baseline and noise
+ *
+ * \param sensor Tracker to update
+ *
+ * \return None
+ */
+static void updateThreshold(PhotoSensor *sensor)
+{
+    int32_t base = (sensor->baseline + (1 << (PHOTO_FRAC - 1))) >> PHOTO_FRAC;
+    int32_t margin = (sensor->noise * PHOTO_NOISE_MARGIN) >> PHOTO_FRAC;
+    int32_t threshold = (base * PHOTO_TRIGGER_FRAC) >> 8;
+
+    if (margin < PHOTO_MIN_MARGIN)
+    {
+        margin = PHOTO_MIN_MARGIN;
+    }
+    // Flickering light keeps the threshold further from the baseline
+    if (threshold > base - margin)
+    {
+        threshold = base - margin;
+    }
+    // Too dark to tell a prize from the ambient light
+    if (threshold < 0)
+    {
+        threshold = 0;
+    }
+    sensor->threshold = threshold;
+}
+
+void initPhotoSensor(PhotoSensor *sensor, uint16_t threshold)
+{
+    sensor->baseline = ((int32_t)threshold << (PHOTO_FRAC + 8)) / PHOTO_TRIGGER_FRAC;
+    sensor->noise = 0;
+    sensor->learned = 0;
+    sensor->shift = 0;
+    sensor->threshold = threshold;
+    sensor->run = 0;
+    sensor->confidence = 0;
+}
+
+bool updatePhotoSensor(PhotoSensor *sensor, uint16_t sample, bool learning)
+{
+    int32_t error, base, depth, score;
+
+    if (learning)
+    {
+        // Weight 1/2^shift, growing towards 1/2^PHOTO_LEARN_SHIFT as samples
+        //  are learned, so the first ones settle the baseline quickly
+        if (sensor->learned < (1 << PHOTO_LEARN_SHIFT))
+        {
+            sensor->learned++;
+            if (sensor->learned >> (sensor->shift + 1))
+            {
+                sensor->shift++;
+            }
+        }
+
+        error = ((int32_t)sample << PHOTO_FRAC) - sensor->baseline;
+        sensor->baseline += error >> sensor->shift;
+        sensor->noise += (((error < 0) ? -error : error) - sensor->noise) >> sensor->shift;
+        updateThreshold(sensor);
+    }
+
+    if (sample >= sensor->threshold)
+    {
+        sensor->run = 0;
+        sensor->confidence = 0;
+        return false;
+    }
+
+    if (sensor->run < PHOTO_CONFIRM)
+    {
+        sensor->run++;
+    }
+
+    // Half confidence right at the threshold, full at twice as far below the
+    //  baseline, scaled down until the run is confirmed
+    base = (sensor->baseline + (1 << (PHOTO_FRAC - 1))) >> PHOTO_FRAC;
+    depth = base - sample;
+    score = depth * (PHOTO_CONFIDENCE_MAX + 1) / (2 * (base - sensor->threshold));
+    if (score > PHOTO_CONFIDENCE_MAX)
+    {
+        score = PHOTO_CONFIDENCE_MAX;
+    }
+    sensor->confidence = score * sensor->run / PHOTO_CONFIRM;
+
+    return sensor->run >= PHOTO_CONFIRM;
+}
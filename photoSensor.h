@@ -0,0 +1,90 @@
+/*! \file */
+/*!
+ * photoSensor.h
+ *
+ * Description: Adaptive dark detection for one photoresistor, run on every
+ *              ADC frame. While no prize can be dropped, the tracker learns
+ *              the ambient level as a slow integer IIR, along with how far
+ *              the readings stray from it. The trigger threshold follows
+ *              from both: a fixed fraction of the ambient level, but never
+ *              closer to it than the noise allows. A reading only counts as
+ *              dark after PHOTO_CONFIRM consecutive samples below the
+ *              threshold, which rejects flicker and passing shadows.
+ *
+ *              Every call costs the same few multiplies and shifts, plus
+ *              one divide while the sensor is below its threshold.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef PHOTOSENSOR_H_
+#define PHOTOSENSOR_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PHOTO_FRAC                  10          // Fractional bits of the baseline and noise
+#define PHOTO_LEARN_SHIFT           8           // Learning weight once settled, 1/256 (250 ms at 1024 Hz)
+#define PHOTO_TRIGGER_FRAC          128         // Threshold as a fraction of baseline (/256)
+#define PHOTO_NOISE_MARGIN          4           // Threshold at least this many noise levels below baseline
+#define PHOTO_MIN_MARGIN            24          // Threshold at least this many counts below baseline
+#define PHOTO_CONFIRM               4           // Consecutive dark samples that make a detection
+#define PHOTO_CONFIDENCE_MAX        255
+
+typedef struct
+{
+    int32_t baseline;           // Ambient reading (counts, Q10)
+    int32_t noise;              // Mean distance of readings from baseline (counts, Q10)
+    uint16_t learned;           // Samples learned, up to 1 << PHOTO_LEARN_SHIFT
+    uint8_t shift;              // Weight of a learned sample is 1/2^shift
+    uint16_t threshold;         // Readings below this are dark, 0 = never
+    uint8_t run;                // Consecutive dark samples, up to PHOTO_CONFIRM
+    volatile uint8_t confidence;    // How sure the latest sample is dark, 0 to PHOTO_CONFIDENCE_MAX
+} PhotoSensor;
+
+/*!
+ * \brief Initializes a tracker that has not learned anything yet
+ *
+ * \param sensor    Tracker to initialize
+ * \param threshold Threshold to use until the first sample is learned
+ *
+ * \return None
+ */
+extern void initPhotoSensor(PhotoSensor *sensor, uint16_t threshold);
+
+/*!
+ * \brief Runs one sample through the tracker
+ *
+ * The first samples learned replace the starting threshold almost at once,
+ *  later ones move the baseline by 1/2^PHOTO_LEARN_SHIFT each.
+ *
+ * \param sensor   Tracker to update
+ * \param sample   Raw ADC reading
+ * \param learning true while nothing should be covering the sensor
+ *
+ * \return true once PHOTO_CONFIRM samples in a row were below the threshold
+ */
+extern bool updatePhotoSensor(PhotoSensor *sensor, uint16_t sample, bool learning);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PHOTOSENSOR_H_ */
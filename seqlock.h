@@ -0,0 +1,131 @@
+/*! \file */
+/*!
+ * seqlock.h
+ *
+ * Description: Sequence counter for state that an interrupt handler
+ *              publishes and the main loop reads as a whole. The writer
+ *              makes the count odd while it changes the state and even
+ *              again when it is done. A reader copies the state and copies
+ *              it again if the count was odd or moved meanwhile, so it
+ *              never ends up with fields from two different updates.
+ *              Neither side disables interrupts and the writer never waits.
+ *
+ *              A reader must never interrupt the writer, or it would spin
+ *              on the odd count forever: read from the main loop only. The
+ *              main loop may also write, because it never reads while it
+ *              writes and a handler that interrupts it leaves the count
+ *              odd again when it returns.
+ *
+ *              The other way round, a handler reading what the main loop
+ *              publishes cannot wait for the update to finish. It uses
+ *              seqTryReadBegin() instead and leaves the state for a later
+ *              interrupt if it is being written.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "msp.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef volatile uint32_t SeqLock;
+
+/*!
+ * \brief Marks the start of an update
+ *
+ * \param seq Sequence count of the state
+ *
+ * \return None
+ */
+static inline void seqWriteBegin(SeqLock *seq)
+{
+    *seq += 1;
+    __DMB();
+}
+
+/*!
+ * \brief Marks the end of an update
+ *
+ * \param seq Sequence count of the state
+ *
+ * \return None
+ */
+static inline void seqWriteEnd(SeqLock *seq)
+{
+    __DMB();
+    *seq += 1;
+}
+
+/*!
+ * \brief Starts copying the state
+ *
+ * \param seq Sequence count of the state
+ *
+ * \return Count to hand to seqReadRetry()
+ */
+static inline uint32_t seqReadBegin(const SeqLock *seq)
+{
+    uint32_t start;
+
+    do
+    {
+        start = *seq;
+    } while (start & 1);
+    __DMB();
+    return start;
+}
+
+/*!
+ * \brief Starts copying the state from an interrupt handler, without waiting
+ *
+ * \param seq   Sequence count of the state
+ * \param start Receives the count to hand to seqReadRetry()
+ *
+ * \return false if the main loop is writing the state
+ */
+static inline bool seqTryReadBegin(const SeqLock *seq, uint32_t *start)
+{
+    *start = *seq;
+    __DMB();
+    return !(*start & 1);
+}
+
+/*!
+ * \brief Checks whether the copy has to be taken again
+ *
+ * \param seq   Sequence count of the state
+ * \param start Count returned by seqReadBegin()
+ *
+ * \return true if the state changed while it was being copied
+ */
+static inline bool seqReadRetry(const SeqLock *seq, uint32_t start)
+{
+    __DMB();
+    return *seq != start;
+}
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEQLOCK_H_ */
@@ -21,6 +21,30 @@ uint16_t pulseWidthTicks = SERVO_MIN_ANGLE;
 
 int curAngle;
 
+// Pulse width waiting for the next PWM period, and periods waited so far
+volatile uint16_t pendingPulseTicks;
+volatile bool pulsePending;
+uint8_t pulseDeferrals;
+
+/*!
+ * Queues a new pulse width for the TA2 CCR0 interrupt to load at the start
+ *  of a PWM period.
+ *
+ * \param ticks Positive pulse-width in Timer_A2 ticks
+ *
+ * \return None
+ */
+static void setPulseWidth(uint16_t ticks)
+{
+    if (!pulsePending && TIMER_A2->CCR[1] == ticks)
+    {
+        return;
+    }
+    pendingPulseTicks = ticks;
+    pulsePending = true;
+    TIMER_A2->CCTL[0] |= TIMER_A_CCTLN_CCIE;
+}
+
 void initServoMotor(void) {
     // Configure servo pin (P5.6) for primary module function (TA2.1),
     // output, initially LOW
@@ -44,6 +68,10 @@ void initServoMotor(void) {
     TIMER_A2->EX0 = 0b0000000000000101;
     TIMER_A2->CTL = 0b0000001000010100;
 
+    // CCR0 interrupt loads new pulse widths, only enabled while one is pending
+    TIMER_A2->CCTL[0] = 0;
+    NVIC->ISER[TA2_0_IRQn >> 5] = 1 << (TA2_0_IRQn & 0x1F);
+
     setServoAngle(MAX_ANGLE);
 }
 
@@ -54,12 +82,12 @@ void incrementTenDegree(void) {
         pulseWidthTicks = SERVO_MIN_ANGLE;
     }
     // Update CCR1 register to set new positive pulse-width
-    TIMER_A2->CCR[1] = pulseWidthTicks;
+    setPulseWidth(pulseWidthTicks);
 }
 
 void setServoAngle(uint8_t angle) {
     // Useful function for driver
-    TIMER_A2->CCR[1] = SERVO_MIN_ANGLE + ONE_DEGREE_TICKS * angle;
+    setPulseWidth(SERVO_MIN_ANGLE + ONE_DEGREE_TICKS * angle);
     curAngle = angle;
 }
 
@@ -76,3 +104,20 @@ void toggleServo()
     }
     setServoAngle(curAngle);
 }
+
+// Timer A2 CCR0 interrupt service routine, at the start of every PWM period
+void TA2_0_IRQHandler(void)
+{
+    // Load the new width now unless its falling edge would land on a
+    //  stepper coil edge, but never hold it back for long
+    if (pulsePending && (!stepperEdgeNear(pendingPulseTicks * SERVO_TO_STEPPER_TICKS)
+                             || ++pulseDeferrals > SERVO_MAX_DEFER))
+    {
+        TIMER_A2->CCR[1] = pendingPulseTicks;
+        pulsePending = false;
+        pulseDeferrals = 0;
+        TIMER_A2->CCTL[0] &= ~(TIMER_A_CCTLN_CCIE);
+    }
+    // Clear timer compare flag in TA2CCTL0
+    TIMER_A2->CCTL[0] &= ~(TIMER_A_CCTLN_CCIFG);
+}
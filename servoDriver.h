@@ -25,6 +25,7 @@ extern "C"
 #endif
 
 #include "msp.h"
+#include "stepperMotor.h"
 
 // TODO add tick count values for constants
 #define FREQUENCY                       2000000
@@ -38,6 +39,11 @@ extern "C"
 #define MAX_ANGLE                       120
 #define MIN_ANGLE                       40
 
+// Pulse width changes wait at most this many PWM periods for a falling
+//  edge clear of the stepper coil edges
+#define SERVO_MAX_DEFER                 4
+#define SERVO_TO_STEPPER_TICKS          (CLK_RATE / FREQUENCY)
+
 
 /*!
  * \brief This function configures pins and timer for servo motor driver
@@ -69,11 +75,13 @@ extern void incrementTenDegree(void);
 /*!
  * \brief This function sets angle of servo
  *
- * This function sets angle of servo to \a angle (between 0 to 180)
+ * This function sets angle of servo to \a angle (between 0 to 180). The new
+ *  pulse width is loaded at the start of a PWM period whose falling edge
+ *  keeps clear of the stepper coil edges, see stepperEdgeNear().
  *
  *  \param angle Angle in degrees to set servo (between 0 to 180)
  *
- * Modified \b TA2CCR1 register.
+ * Modified \b TA2CCR1 register from the TA2 CCR0 interrupt.
  *
  * \return None
  */
@@ -0,0 +1,19 @@
+/*! \file */
+/*!
+ * snapshot.c
+ *
+ * Description: Gathers the state the interrupt handlers publish into one
+ *              copy for the main loop.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "snapshot.h"
+
+void readSnapshot(Snapshot *snapshot)
+{
+    readAdcSnapshot(&snapshot->adc);
+    readClock(&snapshot->clock);
+    readButton(&snapshot->button);
+}
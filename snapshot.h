@@ -0,0 +1,62 @@
+/*! \file */
+/*!
+ * snapshot.h
+ *
+ * Description: One consistent copy of everything the interrupt handlers
+ *              hand to the main loop: the latest ADC frame with its joystick
+ *              deflections, the game clock and the button state. Each part
+ *              is published by its own handler behind a sequence counter
+ *              (see seqlock.h), so every part is whole even if a handler
+ *              runs while it is copied. The parts come from independent
+ *              interrupts and are not taken at one instant with each other.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "adc.h"
+#include <timer32.h>
+#include "sw.h"
+
+typedef struct
+{
+    AdcSnapshot adc;            // From the ADC14 frame interrupt
+    ClockSnapshot clock;        // From the Timer32_1 interrupt
+    ButtonSnapshot button;      // From the button capture interrupt
+} Snapshot;
+
+/*!
+ * \brief Copies the state shared with the interrupt handlers
+ *
+ * Never disables interrupts. Main loop only.
+ *
+ * \param snapshot Receives the state
+ *
+ * \return None
+ */
+extern void readSnapshot(Snapshot *snapshot);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SNAPSHOT_H_ */
@@ -10,27 +10,25 @@
 
 #include "stateMachine.h"
 
-// External pushbutton variables
-extern int pressed;
-
-// Real time variables
-extern int record;
-extern int curTime;
-extern int resetNeeded;
-extern int lastPressed;
+// State shared with the interrupt handlers, copied once per state update
+static Snapshot now;
+static uint32_t lastUpdate;     // now.clock.eighths of the last gameplay update
 
 // LCD variables
-char lcdText[] = "                                "; // 32 spaces
-
-// ADC variables
-extern volatile bool resultReady;
-extern int xVal, yVal, photoVal;
+char lcdText[LCD_LINE_SIZE];
 
 // File-specific variables related to scoring and time
 int winTime;
 int score;
 int bonus;
-int winTicks;
+uint32_t winSpeed;      // Of the prize between the photoresistors (mm/s), 0 if not timed
+uint32_t winHeight;     // Estimated drop height of the prize (mm)
+
+#ifdef ADC_BENCHMARK
+// From the first dark sample to the game reacting. The time before that,
+//  from the light dropping to the sample, needs a scope on the sensor.
+uint32_t winNoticeTicks;    // Latency of the last win, in TIMESTAMP_RATE ticks
+#endif
 
 void initState()
 {
@@ -39,131 +37,194 @@ void initState()
 
 void showWon(void)
 {
+    uint8_t pos;
+
     // Steppers should be stationary
-    disableStepperMotor();
-    disableStepperMotor2();
+    disableStepperMotor(STEPPER_X);
+    disableStepperMotor(STEPPER_Y);
 
     // Gripper should be open
     setServoAngle(MIN_ANGLE);
 
+    readSnapshot(&now);
+
     // Show winning message
-    sprintf(lcdText, "WINNER! Score=%d Button=restart", score);
+    pos = clearLine(lcdText);
+    pos = putText(lcdText, pos, "WINNER! Score=");
+    pos = putInt(lcdText, pos, score, SCORE_DIGITS);
+    putText(lcdText, pos, " Button=restart");
     updateDispVal(lcdText);
 
     // If reset button pressed, change state
-    if (resetNeeded)
+    if (now.button.resetNeeded)
     {
         curState = RESETTING_STATE;
-        curTime = RESET_TIME;
-        resetNeeded = 0;
+        setTimeLeft(RESET_TIME);
+        clearResetRequest();
     }
 }
 
 void showLost(void)
 {
     // Steppers should be stationary
-    disableStepperMotor();
-    disableStepperMotor2();
+    disableStepperMotor(STEPPER_X);
+    disableStepperMotor(STEPPER_Y);
 
     // Gripper should be open
     setServoAngle(MIN_ANGLE);
 
+    readSnapshot(&now);
+
     // Show losing message
-    sprintf(lcdText, "Game over! Button to restart");
+    putText(lcdText, clearLine(lcdText), "Game over! Button to restart");
     updateDispVal(lcdText);
 
     // If reset button pressed, change state and time
-    if (resetNeeded)
+    if (now.button.resetNeeded)
     {
         curState = RESETTING_STATE;
-        curTime = RESET_TIME;
-        resetNeeded = 0;
+        setTimeLeft(RESET_TIME);
+        clearResetRequest();
     }
 }
 
 void reset(void)
 {
+    uint8_t pos;
+
+    // Nobody should be touching the joystick or dropping prizes between rounds
+    calibrateJoystick();
+    learnAmbientLight();
+    readSnapshot(&now);
+
     // Gripper should be open
     setServoAngle(MIN_ANGLE);
 
-    // Show resetting message with countdown
-    sprintf(lcdText, "Resetting... %d", curTime);
+    if (stepperHomed(STEPPER_X) && stepperHomed(STEPPER_Y))
+    {
+        bool home = stepperAxes[STEPPER_X].position == 0 && stepperAxes[STEPPER_Y].position == 0;
+
+        // Position is known, so drive straight back to home at full speed,
+        // moving right and up along one line so both axes arrive together
+        putText(lcdText, clearLine(lcdText), "Resetting...");
+        updateDispVal(lcdText);
+
+        if (!home && !linearMoveActive())
+        {
+            moveSteppersLinear(-stepperAxes[STEPPER_X].position, -stepperAxes[STEPPER_Y].position,
+                               RPM_TO_PERIOD(MAX_RPM));
+        }
+
+        // Start the countdown as soon as both axes are home, RESET_TIME
+        // only serves as a timeout
+        if ((home && !linearMoveActive()) || now.clock.timeLeft == 0)
+        {
+            curState = READY_START_STATE;
+            setTimeLeft(COUNTDOWN_TIME);
+        }
+        return;
+    }
+
+    // Position unknown (first round after power-up): run both axes against
+    // their end stops for RESET_TIME, then take that as home
+    pos = putText(lcdText, clearLine(lcdText), "Resetting... ");
+    putInt(lcdText, pos, now.clock.timeLeft, TIME_DIGITS);
     updateDispVal(lcdText);
 
     // Move horizontal stepper motor to the right
-    setDirection(CCW_DIR);
-    enableStepperMotor();
-    setRPM(MAX_RPM);
+    setDirection(STEPPER_X, CCW_DIR);
+    setStepPeriod(STEPPER_X, RPM_TO_PERIOD(MAX_RPM));
+    enableStepperMotor(STEPPER_X);
 
     // Move vertical stepper motor upwards
-    setDirection2(CW_DIR);
-    enableStepperMotor2();
-    setRPM2(MAX_RPM);
+    setDirection(STEPPER_Y, CW_DIR);
+    setStepPeriod(STEPPER_Y, RPM_TO_PERIOD(MAX_RPM));
+    enableStepperMotor(STEPPER_Y);
 
     // If reset time is done, start the countdown
     // for the player's round
-    if (curTime == 0)
+    if (now.clock.timeLeft == 0)
     {
+        // Soft limits stop both axes right here at the new home
+        setStepperHome(STEPPER_X);
+        setStepperHome(STEPPER_Y);
         curState = READY_START_STATE;
-        curTime = COUNTDOWN_TIME;
+        setTimeLeft(COUNTDOWN_TIME);
     }
 }
 
 void countDown(void)
 {
+    uint8_t pos;
+
+    // Nobody should be touching the joystick or dropping prizes yet
+    calibrateJoystick();
+    learnAmbientLight();
+    readSnapshot(&now);
+
     // Steppers should be stationary
-    disableStepperMotor();
-    disableStepperMotor2();
+    disableStepperMotor(STEPPER_X);
+    disableStepperMotor(STEPPER_Y);
+
+    // Writing flash stalls the step interrupt, so only once both have stopped
+    if (stepperAtRest(STEPPER_X) && stepperAtRest(STEPPER_Y))
+    {
+        saveJoystickCalibration();
+    }
 
     // Gripper should be closed
     setServoAngle(MAX_ANGLE);
 
     // Show countdown message
-    sprintf(lcdText, "Starting in... %d", curTime);
+    pos = putText(lcdText, clearLine(lcdText), "Starting in... ");
+    putInt(lcdText, pos, now.clock.timeLeft, TIME_DIGITS);
     updateDispVal(lcdText);
 
     // If the countdown is over, start the round!
-    if (curTime == 0)
+    if (now.clock.timeLeft == 0)
     {
         curState = JOYSTICK_MOVE_STATE;
-        curTime = GAMEPLAY_TIME;
+        setTimeLeft(GAMEPLAY_TIME);
+        armWinDetect();
     }
 }
 
 void moveJoystick(void)
 {
-    // Sample all ADC channels
-    adcSample();
-    while (!resultReady);
-    resultReady = false;
+    WinEvent win;
+    uint8_t pos;
+
+    readSnapshot(&now);
 
     // If user has run out of time, they lose
-    if (curTime == 0)
+    if (now.clock.timeLeft == 0)
     {
-        lastPressedTime = RESET_LAST_PRESSED_TIME;
+        forgetLastPress();
         curState = GAME_OVER_STATE;
     }
 
     // If object is detected, they win
-    else if (photoVal < TOO_DARK || photoVal2 < TOO_DARK)
+    else if (winDetected(&win))
     {
-        photoVal = 1000;
-        photoVal2 = 1000;
-        winTime = curTime;
-        winTicks = TIMER_A0->R;
-        calculateBonus();
+#ifdef ADC_BENCHMARK
+        // Time from the dark conversion until the game reacts
+        winNoticeTicks = readTimestamp() - win.timestamp;
+#endif
+        winTime = now.clock.timeLeft;
+        calculateBonus(&win);
         score = winTime + bonus;
-        lastPressedTime = RESET_LAST_PRESSED_TIME;
+        forgetLastPress();
         curState = GAME_WON_STATE;
     }
 
     // Otherwise, update the actuators as necessary
-    else if (record)
+    else if (now.clock.eighths != lastUpdate)
     {
         // Update LCD with time remaining
-        sprintf(lcdText, "GO! Time: %d", curTime);
+        pos = putText(lcdText, clearLine(lcdText), "GO! Time: ");
+        putInt(lcdText, pos, now.clock.timeLeft, TIME_DIGITS);
         updateDispVal(lcdText);
-        record = 0;
+        lastUpdate = now.clock.eighths;
 
         // Update stepper movement
         moveSteppers();
@@ -179,93 +240,113 @@ void initializeAll(void)
     setupLCD();
     initializeSwitches();
     initializeRGBLEDs();
+    initDma();
     initADCPorts();
     configureADC14();
-    initStepperMotor2();
-    initStepperMotor();
-    disableStepperMotor();
+    initJoystickCalibration();
+    initStepperMotors();
     initServoMotor();
     initState();
     __enable_irq();
 }
 
-void moveSteppers(void)
+/*!
+ * \brief Drives one stepper axis from a filtered joystick reading
+ *
+ * Queues the next segment for the step interrupt as soon as the previous
+ *  one has started, instead of changing the running motor directly. The
+ *  fractional part of the deflection interpolates between neighbouring
+ *  entries of the joystick map, so oversampled readings give finer speeds.
+ *
+ * \param axis       Stepper axis to drive
+ * \param deflection Filtered joystick deflection for that axis (Q4)
+ * \param posDir     Stepper direction for readings above the centre
+ *
+ * \return None
+ */
+static void moveAxis(uint8_t axis, int deflection, int posDir)
 {
-    // Handle x-direction movement by translating x-coordinate to a direction and RPM
-    if (xVal < MID_RANGE - REST_ERROR)
-    {
-        setDirection(CCW_DIR);
-        enableStepperMotor();
-        double RPM = (((MAX_VAL - xVal) - (MID_RANGE + REST_ERROR)) / MAX_DIFF) * (MAX_RPM - MIN_RPM) + MIN_RPM;
-        setRPM(RPM);
-    }
-    else if (xVal > MID_RANGE + REST_ERROR)
+    int reading = (MID_RANGE << JOY_DEFLECT_FRAC) + deflection;
+    int frac = reading & ((1 << JOY_DEFLECT_FRAC) - 1);
+    const JoystickStep *step;
+    int period;
+
+    // The map covers the 10-bit range around MID_RANGE
+    if (reading < 0)
     {
-        setDirection(CW_DIR);
-        enableStepperMotor();
-        double RPM = ((xVal - (MID_RANGE + REST_ERROR + 1)) / (MAX_DIFF - 1.0)) * (MAX_RPM - MIN_RPM) + MIN_RPM;
-        setRPM(RPM);
+        reading = 0;
+        frac = 0;
     }
-    else
+    else if (reading >= MAX_VAL << JOY_DEFLECT_FRAC)
     {
-        disableStepperMotor();
+        reading = MAX_VAL << JOY_DEFLECT_FRAC;
+        frac = 0;
     }
+    step = &joystickMap[reading >> JOY_DEFLECT_FRAC];
 
-    // Handle y-direction movement by translating y-coordinate to a direction and RPM
-    if (yVal < MID_RANGE - REST_ERROR)
+    period = step->period;
+    if (frac != 0 && step[1].dir == step->dir)
     {
-        setDirection2(CW_DIR);
-        enableStepperMotor2();
-        double RPM = (((MAX_VAL - yVal) - (MID_RANGE + REST_ERROR)) / MAX_DIFF) * (MAX_RPM - MIN_RPM) + MIN_RPM;
-        setRPM2(RPM);
+        period += ((int)step[1].period - period) * frac / (1 << JOY_DEFLECT_FRAC);
     }
-    else if (yVal > MID_RANGE + REST_ERROR)
+
+    if (step->dir == JOY_DIR_NONE)
     {
-        setDirection2(CCW_DIR);
-        enableStepperMotor2();
-        double RPM = ((yVal - (MID_RANGE + REST_ERROR + 1)) / (MAX_DIFF - 1.0)) * (MAX_RPM - MIN_RPM) + MIN_RPM;
-        setRPM2(RPM);
+        disableStepperMotor(axis);
     }
-    else
+    else if (stepperSegmentsQueued(axis) == 0)
     {
-        disableStepperMotor2();
+        queueStepperSegment(axis, (step->dir == JOY_DIR_POS) ? posDir : !posDir,
+                            period, MOVE_SEGMENT_TICKS / period + 1);
     }
 }
 
-void calculateBonus(void)
+void moveSteppers(void)
 {
-    // drop right above: 6106 ticks elapse
-    // drop from maximum height: 13109 ticks elapse
+    // Handle x-direction movement by looking up the x-coordinate's direction and period
+    moveAxis(STEPPER_X, now.adc.deflection[ADC_SAMPLE_X], CW_DIR);
+
+    // Handle y-direction movement, pushing the joystick up moves the claw up (CW)
+    moveAxis(STEPPER_Y, now.adc.deflection[ADC_SAMPLE_Y], CCW_DIR);
+}
+
+void calculateBonus(const WinEvent *win)
+{
+    uint32_t fallTicks;
+
+    winSpeed = 0;
+    winHeight = 0;
 
     // Prize has to have been dropped less than 1 second before detection
     // This is because an object dropped from rest 15 inches off the ground
     // will hit the ground in much less than 1 second
-    if (lastPressedTime - winTime < 2)
+    if (now.button.lastPressedTime - winTime < 2)
     {
-        // Compute the number of ticks elapsed between release and landing
-        if (winTicks <= lastPressed)
-        {
-            bonus = (winTicks + (MAX_16_BIT - lastPressed));
-        }
-        else
-        {
-            bonus = winTicks - lastPressed;
-        }
-
-        // Re-scale bonus score based on how much time elapsed between release and landing
-        if (bonus > BONUS_CUTOFF && bonus < ONE_SECOND_TICKS)
+        if ((win->darkened & WIN_SENSOR(DROP_UPPER_SENSOR)) && (win->darkened & WIN_SENSOR(DROP_LOWER_SENSOR))
+            && (int32_t)(win->darkAt[DROP_LOWER_SENSOR] - win->darkAt[DROP_UPPER_SENSOR]) > 0)
         {
-            bonus = (bonus - BONUS_CUTOFF) / BONUS_SCALE;
+            // Timed past both photoresistors, independent of the gripper
+            winSpeed = dropSpeed(win->darkAt[DROP_LOWER_SENSOR] - win->darkAt[DROP_UPPER_SENSOR], TIMESTAMP_RATE);
+            winHeight = heightFromSpeed(winSpeed);
         }
         else
         {
-            bonus = 0; // Wasn't dropped from high enough, no bonus
+            // Only one photoresistor saw it, time the fall from the release
+            fallTicks = (uint16_t)(win->buttonTicks - now.button.lastPressed);
+            if (fallTicks < ONE_SECOND_TICKS)
+            {
+                winHeight = heightFromFallTime(fallTicks);
+            }
         }
     }
 
-    // If bonus criteria not satisfied from time constraints, no bonus
+    // Re-scale bonus score based on how far the prize fell
+    if (winHeight > BONUS_MIN_HEIGHT && winHeight < BONUS_MAX_HEIGHT)
+    {
+        bonus = (winHeight - BONUS_MIN_HEIGHT) / BONUS_MM_PER_POINT;
+    }
     else
     {
-        bonus = 0;
+        bonus = 0; // Wasn't dropped from high enough, no bonus
     }
 }
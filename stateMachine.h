@@ -30,11 +30,14 @@ extern "C"
 #include "sw.h"
 #include "led.h"
 #include "stepperMotor.h"
-#include "stepperMotor2.h"
 #include "servoDriver.h"
+#include "joystickMap.h"
+#include "joystickCal.h"
+#include "dropPhysics.h"
+#include "snapshot.h"
+#include "lcdFormat.h"
 #include "stateMachine.h"
 #include <stdint.h>
-#include <stdio.h>
 
 #define RESETTING_STATE     0
 #define READY_START_STATE   1
@@ -42,10 +45,26 @@ extern "C"
 #define GAME_WON_STATE      3
 #define GAME_OVER_STATE     4
 
+// Joystick motion segments last one and a half main loop updates (8 Hz),
+// so the claw keeps moving when the main loop is late
+#define MOVE_SEGMENT_TICKS  (CLK_RATE / 8 * 3 / 2)
+
 #define MAX_16_BIT          65535
-#define BONUS_CUTOFF        4000
-#define BONUS_SCALE         1000
 #define ONE_SECOND_TICKS    32768
+#define BONUS_MIN_HEIGHT    100         // mm a prize has to fall for any bonus
+#define BONUS_MAX_HEIGHT    600         // mm, anything higher is a mis-measurement
+#define BONUS_MM_PER_POINT  30          // mm of extra fall per bonus point
+
+// LCD fields, right-aligned so the text around them never moves
+#define TIME_DIGITS         2           // Seconds left in any state
+#define SCORE_DIGITS        2           // "WINNER! Score=" fills line 1 with them
+
+#if RESET_TIME > 99 || COUNTDOWN_TIME > 99 || GAMEPLAY_TIME > 99
+#error "Times need more than TIME_DIGITS on the LCD"
+#endif
+#if GAMEPLAY_TIME + (BONUS_MAX_HEIGHT - BONUS_MIN_HEIGHT) / BONUS_MM_PER_POINT > 99
+#error "Scores need more than SCORE_DIGITS on the LCD"
+#endif
 
 int curState;
 
@@ -114,6 +133,8 @@ void initializeAll(void);
 /*
  * \brief Translates joystick position to claw movement.
  *
+ * Uses the joystick deflections of the latest snapshot.
+ *
  * \param       None
  * \return      None
  */
@@ -122,10 +143,14 @@ void moveSteppers(void);
 /*
  * \brief Computes bonus score when player wins a round.
  *
- * \param       None
+ * The bonus grows with the height the prize was dropped from, estimated
+ * from its transit past both photoresistors, or from the time since the
+ * claw opened if only one of them saw it.
+ *
+ * \param       win Detection of the prize
  * \return      None
  */
-void calculateBonus(void);
+void calculateBonus(const WinEvent *win);
 
 //*****************************************************************************
 //
@@ -3,7 +3,9 @@
  * stepperMotor.c
  *
  * Description: Stepper motor ULN2003 driver for MSP432P4111 Launchpad.
- *              Uses Timer_A3 and P2.7, P2.6, P2.5, P2.4
+ *              One driver serves every axis in stepperConfig. Each step is a
+ *              lookup of the precomputed port bits for the next sequence
+ *              position and a single write to the port.
  *
  *  Created on: 01/09/2023
  *      Author: Vineet Ranade & Yao Xiong
@@ -14,113 +16,1369 @@
 
 /* Global Variables  */
 // Fill in array with 4-bit binary sequence for wave drive (half step)
+//  bit 3 drives IN1, bit 0 drives IN4
 const uint8_t stepperSequence[STEP_SEQ_CNT] = {0b1001, 0b0001, 0b0011, 0b0010, 0b0110, 0b0100, 0b1100, 0b1000};
-uint16_t stepPeriod = INIT_PERIOD;
-uint8_t currentStep = 0;
 
-int clockWise = 1;
+// Pins and compare register of each axis
+static const StepperAxisConfig stepperConfig[NUM_STEPPERS] = {
+    // STEPPER_X: horizontal axis on P2 and TA3 CCR1
+    { &STEPPER_PORT->OUT, &STEPPER_PORT->DIR, &STEPPER_PORT->SEL0, &STEPPER_PORT->SEL1,
+      { STEPPER_IN1, STEPPER_IN2, STEPPER_IN3, STEPPER_IN4 },
+      1, false, IDLE_OFF, CW_DIR, CCW_DIR, STEPPER_X_TRAVEL },
+    // STEPPER_Y: vertical axis on P6 and TA3 CCR2, P6 only shares analog inputs.
+    //  Keeps a reduced hold so the claw stays up.
+    { &STEPPER_PORT2->OUT, &STEPPER_PORT2->DIR, &STEPPER_PORT2->SEL0, &STEPPER_PORT2->SEL1,
+      { STEPPER_IN12, STEPPER_IN22, STEPPER_IN32, STEPPER_IN42 },
+      2, true, IDLE_CHOP, CCW_DIR, CW_DIR, STEPPER_Y_TRAVEL },
+};
 
+#if NUM_STEPPERS > MAX_STEPPERS
+#error "Only CCR1 to CCR4 of STEPPER_TIMER are available for stepper axes"
+#endif
 
-void initStepperMotor(void) {
-    // set stepper port pins as GPIO outputs
-    STEPPER_PORT->SEL0 = (STEPPER_PORT->SEL0) & ~STEPPER_MASK;
-    STEPPER_PORT->SEL1 = (STEPPER_PORT->SEL1) & ~STEPPER_MASK;
-    STEPPER_PORT->DIR = (STEPPER_PORT->DIR) | STEPPER_MASK;
+StepperAxis stepperAxes[NUM_STEPPERS];
 
-    // initialize stepper outputs to LOW
-    STEPPER_PORT->OUT = (STEPPER_PORT->OUT) & ~STEPPER_MASK;
+// Axis served by each compare register, indexed by CCR number
+static StepperAxis *ccrAxis[MAX_STEPPERS + 1];
 
-    /* Configure Timer_A3 and CCR0 */
-    // Set period of Timer_A3 in CCR0 register for Up Mode
-    TIMER_A3->CCR[0] = stepPeriod;
-    // TODO configure CCR0 for Compare mode with interrupt enabled (no output mode - 0)
-    TIMER_A3->CCTL[0] = 0b0000000000010000;
+// Whether the next idle tick compare turns chopped coils on or off
+static bool idleChopOn;
 
-    // Configure Timer_A3 in Stop Mode, with source SMCLK, prescale 3:1, and
-    //  interrupt disabled  -  tick rate will be 4MHz (for SMCLK = 12MHz)
-    // TODO configure Timer_A3 (requires setting control AND expansion register)
-    TIMER_A3->CTL = 0b0000001000000100;
-    TIMER_A3->EX0 = 0b0000000000000010;
+// Whether idle tick compares switch any coils
+static bool idleChopping;
 
-    /* Configure global interrupts and NVIC */
-    // Enable TA3CCR0 compare interrupt by setting IRQ bit in NVIC ISER0 register
-    // Enable interrupt by setting IRQ bit in NVIC ISER0 register
-    NVIC->ISER[0] |= 0x00004000;
+// Axis being stepped by the DMA, if any
+static StepperAxis *volatile dmaAxis;
+
+// Port bytes for one DMA block, read by both the primary and the alternate
+//  structure in turn
+static uint8_t dmaPattern[STEPPER_DMA_BLOCK];
+
+// Control word of a DMA block: one byte per trigger to the fixed port
+#define STEPPER_DMA_CONTROL     (DMA_DST_INC_NONE | DMA_DST_SIZE_BYTE | DMA_SRC_INC_BYTE \
+                                    | DMA_SRC_SIZE_BYTE | DMA_ARB_1 \
+                                    | DMA_COUNT(STEPPER_DMA_BLOCK) | DMA_MODE_PINGPONG)
+
+#if (STEPPER_DMA_BLOCK % STEP_SEQ_CNT) != 0
+#error "STEPPER_DMA_BLOCK must cover whole step sequences"
+#endif
+
+// Bresenham state of the coordinated move, if any
+static volatile struct
+{
+    bool active;
+    StepperAxis *major;             // Axis whose compare interrupt paces the move
+    StepperAxis *minor;             // Axis stepped from the major axis's ISR
+    int8_t minorDirection;
+    int32_t majorSteps;
+    int32_t minorSteps;
+    int32_t error;
+} linearMove;
+
+
+/*!
+ * Precomputes the port output bits of every step sequence position for an
+ *  axis, and the bit-band alias of each coil pin, so stepping never has to
+ *  shift or mask sequence bits.
+ *
+ * \param axis Axis state with config already set
+ *
+ * \return None
+ */
+static void buildPatterns(StepperAxis *axis)
+{
+    uint8_t pos, coil;
+
+    uint8_t bit;
+
+    axis->mask = 0;
+    for (coil = 0; coil < STEP_COILS; coil++)
+    {
+        axis->mask |= axis->config->pins[coil];
+
+        // Coils on a shared port are written one bit at a time
+        for (bit = 0; (1 << bit) != axis->config->pins[coil]; bit++);
+        axis->coilBit[coil] = gpioBitAlias(axis->config->out, bit);
+    }
+
+    for (pos = 0; pos < STEP_SEQ_CNT; pos++)
+    {
+        axis->pattern[pos] = 0;
+        for (coil = 0; coil < STEP_COILS; coil++)
+        {
+            // Sequence bit 3 drives IN1 down to bit 0 driving IN4
+            if (stepperSequence[pos] & (0b1000 >> coil))
+            {
+                axis->pattern[pos] |= axis->config->pins[coil];
+            }
+        }
+    }
+}
+
+/*!
+ * Drives the coils of an axis to \a coils without a read-modify-write of the
+ *  port, so interrupts writing other bits of it can never be undone. A
+ *  dedicated port takes the whole byte in one store. On a shared port only
+ *  the coils that change are written, each through its own bit-band alias;
+ *  successive half-steps differ in a single coil, so that is one store too.
+ *
+ * \param axis  Axis to update
+ * \param coils Port bits of the coils to energize, within axis->mask
+ *
+ * \return None
+ */
+static inline void writeCoils(StepperAxis *axis, uint8_t coils)
+{
+    uint8_t changed = coils ^ axis->driven;
+    uint8_t coil;
+
+    if (axis->config->dedicatedPort)
+    {
+        *axis->config->out = coils;
+    }
+    else
+    {
+        for (coil = 0; changed != 0; coil++)
+        {
+            if (changed & axis->config->pins[coil])
+            {
+                *axis->coilBit[coil] = (coils & axis->config->pins[coil]) != 0;
+                changed &= ~axis->config->pins[coil];
+            }
+        }
+    }
+    axis->driven = coils;
+}
+
+/*!
+ * Writes the current sequence position of an axis to its port
+ *
+ * \param axis Axis to update
+ *
+ * \return None
+ */
+static inline void writeStep(StepperAxis *axis)
+{
+    writeCoils(axis, axis->pattern[axis->currentStep]);
+}
+
+/*!
+ * Advances an axis \a stride half-steps in \a direction and tracks its
+ *  absolute position in half-steps, counting up away from home.
+ *
+ * \param axis      Axis to step
+ * \param direction CW_DIR or CCW_DIR
+ * \param stride    1 for a half-step, 2 for a full or wave step
+ *
+ * \return None
+ */
+static inline void advanceAxis(StepperAxis *axis, int8_t direction, uint8_t stride)
+{
+    if (direction == CW_DIR)
+    {
+        axis->currentStep = (axis->currentStep + stride) & (STEP_SEQ_CNT - 1);
+    }
+    else
+    {
+        axis->currentStep = (axis->currentStep - stride) & (STEP_SEQ_CNT - 1);
+    }
+    writeStep(axis);
+
+    if (direction == axis->config->homeDirection)
+    {
+        axis->position -= stride;
+    }
+    else
+    {
+        axis->position += stride;
+    }
+}
+
+/*!
+ * Picks how many half-steps the next timer period of an axis covers.
+ *
+ * \param axis      Axis about to be timed
+ * \param remaining Half-steps left before the axis has to stop
+ *
+ * \return 1 or 2
+ */
+static uint8_t chooseStride(const StepperAxis *axis, int32_t remaining)
+{
+    uint8_t mode = axis->stepMode;
+    uint32_t rate = axis->ramp.rate >> RAMP_FRAC_BITS;
+
+    if (mode == STEP_MODE_AUTO)
+    {
+        // Hysteresis keeps the mode from chattering around the threshold
+        if (axis->ramp.stride == 2 ? rate > STEP_AUTO_HALF_BELOW : rate >= STEP_AUTO_FULL_ABOVE)
+        {
+            mode = STEP_MODE_FULL;
+        }
+        else
+        {
+            mode = STEP_MODE_HALF;
+        }
+    }
+
+    if (mode == STEP_MODE_HALF || remaining < 2)
+    {
+        return 1;
+    }
+    // Full steps sit on the even (two coil) sequence positions, wave steps
+    //  on the odd (one coil) ones, so take a half-step first if off by one
+    if ((axis->currentStep & 1) != (mode == STEP_MODE_WAVE))
+    {
+        return 1;
+    }
+    return 2;
+}
+
+/*!
+ * Counts the steps an axis may still take in \a direction before it has to
+ *  be at rest: up to the soft travel limit, or up to the target position if
+ *  seeking one that lies ahead.
+ *
+ * \param axis      Axis to check
+ * \param direction Direction of travel
+ *
+ * \return Steps left, STEPS_UNLIMITED if the axis has not been homed
+ */
+static int32_t stepsToStop(const StepperAxis *axis, int8_t direction)
+{
+    bool towardHome = (direction == axis->config->homeDirection);
+    int32_t toLimit, toTarget;
+
+    if (!axis->homed)
+    {
+        return STEPS_UNLIMITED;
+    }
+
+    toLimit = towardHome ? axis->position : axis->config->travel - axis->position;
+    if (axis->seeking)
+    {
+        toTarget = towardHome ? axis->position - axis->target : axis->target - axis->position;
+        if (toTarget >= 0 && toTarget < toLimit)
+        {
+            return toTarget;
+        }
+    }
+    return toLimit;
+}
+
+/*!
+ * Moves an axis on to the next queued segment once the current one has
+ *  taken its steps. Runs from the step ISR, or from the main loop while the
+ *  axis is at rest and its ISR is off, so the queue only ever has one
+ *  consumer at a time.
+ *
+ * \param axis Axis to update
+ *
+ * \return None
+ */
+static void serviceQueue(StepperAxis *axis)
+{
+    MotionSegment segment;
+
+    // disableStepperMotor() also ends the segment in progress
+    if (applyMotionDiscard(&axis->queue))
+    {
+        axis->segmentSteps = 0;
+        axis->streaming = false;
+    }
+    if (axis->segmentSteps > 0)
+    {
+        return;
+    }
+
+    if (popMotionSegment(&axis->queue, &segment))
+    {
+        setRampDirection(&axis->ramp, segment.direction);
+        setRampTarget(&axis->ramp, segment.period);
+        axis->segmentSteps = segment.steps;
+        axis->streaming = true;
+    }
+    else if (axis->streaming)
+    {
+        // Ran dry, slow down to a stop unless a segment arrives in time
+        setRampTarget(&axis->ramp, 0);
+        axis->streaming = false;
+    }
+}
+
+/*!
+ * Checks whether compare register \a ccr is set for a coil edge, rather
+ *  than an intermediate compare of a long period or nothing at all.
+ *
+ * \param ccr STEPPER_TIMER compare register
+ *
+ * \return true if the compare switches coils
+ */
+static bool compareSwitchesCoils(uint8_t ccr)
+{
+    if (!(STEPPER_TIMER->CCTL[ccr] & TIMER_A_CCTLN_CCIE))
+    {
+        return false;
+    }
+    if (ccr == STEPPER_IDLE_CCR)
+    {
+        return idleChopping;
+    }
+    return ccr <= MAX_STEPPERS && ccrAxis[ccr] != 0 && ccrAxis[ccr]->waitTicks == 0;
+}
+
+/*!
+ * Finds the earliest moment at or after \a at that keeps
+ *  STEPPER_STAGGER_GUARD away from the coil edges scheduled on the other
+ *  compares and by DMA stepping. Each edge found pushes the moment past
+ *  it, then all edges are checked again.
+ *
+ * \param at   Moment in ticks from now
+ * \param self Compare register being scheduled, STEPPER_NO_CCR for none
+ *
+ * \return Clear moment in ticks from now, at most 0xFFFF
+ */
+static int32_t clearEdgeTime(int32_t at, uint8_t self)
+{
+    uint16_t now = STEPPER_TIMER->R;
+    uint8_t pass, ccr;
+    bool moved = true;
+
+    for (pass = 0; moved && pass <= MAX_STEPPERS + 1; pass++)
+    {
+        moved = false;
+        for (ccr = 0; ccr <= MAX_STEPPERS; ccr++)
+        {
+            int32_t edge = (uint16_t)(STEPPER_TIMER->CCR[ccr] - now);
+
+            if (ccr != self && compareSwitchesCoils(ccr)
+                    && at > edge - STEPPER_STAGGER_GUARD && at < edge + STEPPER_STAGGER_GUARD)
+            {
+                at = edge + STEPPER_STAGGER_GUARD;
+                moved = true;
+            }
+        }
+        // The DMA steps every TA1CCR0 + 1 ticks from its next match on
+        if (dmaAxis != 0)
+        {
+            int32_t period = STEPPER_DMA_TIMER->CCR[0] + 1;
+            int32_t offset = at - (uint16_t)(STEPPER_DMA_TIMER->CCR[0] - STEPPER_DMA_TIMER->R);
+
+            if (offset > -STEPPER_STAGGER_GUARD)
+            {
+                int32_t phase = (offset < 0) ? offset : offset % period;
+
+                if (phase < STEPPER_STAGGER_GUARD)
+                {
+                    at += STEPPER_STAGGER_GUARD - phase;
+                    moved = true;
+                }
+                else if (period - phase < STEPPER_STAGGER_GUARD)
+                {
+                    at += period - phase + STEPPER_STAGGER_GUARD;
+                    moved = true;
+                }
+            }
+        }
+    }
+    return (at > 0xFFFF) ? 0xFFFF : at;
+}
+
+/*!
+ * Gap between the minor axis steps of a linear move that are due at the
+ *  same compare of the major axis, see stepperISR()
+ *
+ * \param major Major axis of the move
+ *
+ * \return Gap in ticks, at least STEPPER_STAGGER_GUARD
+ */
+static int32_t minorStepSpacing(const StepperAxis *major)
+{
+    int32_t spacing = major->ramp.period / major->ramp.stride;
+
+    return (spacing < STEPPER_STAGGER_GUARD) ? STEPPER_STAGGER_GUARD : spacing;
+}
+
+/*!
+ * Checks whether a step of an axis beyond its next compare could land near
+ *  \a at, assuming the axis keeps stepping at its current period. The minor
+ *  axis of a linear move steps a guard interval after its major axis, and
+ *  again minorStepSpacing() later for each further half-step of the stride.
+ *  Those later steps are only armed once the one before has been taken, so
+ *  they are projected from the minor axis's compare.
+ *
+ * \param axis Axis to check
+ * \param at   Moment in ticks from now
+ *
+ * \return true if a projected edge lies within STEPPER_STAGGER_GUARD of it
+ */
+static bool projectedEdgeNear(const StepperAxis *axis, int32_t at)
+{
+    int32_t period = axis->ramp.period;
+    int32_t phase, edge;
+    uint8_t i;
+
+    if (axis->deferredSteps > 1)
+    {
+        phase = at - (uint16_t)(STEPPER_TIMER->CCR[axis->config->ccr] - STEPPER_TIMER->R);
+        for (i = 1; i < axis->deferredSteps; i++)
+        {
+            edge = i * minorStepSpacing(linearMove.major);
+            if (phase > edge - STEPPER_STAGGER_GUARD && phase < edge + STEPPER_STAGGER_GUARD)
+            {
+                return true;
+            }
+        }
+    }
+
+    // DMA steps are projected by clearEdgeTime() already
+    if (!axis->ramp.running || axis->dmaActive || axis->waitTicks != 0 || period > 0xFFFF)
+    {
+        return false;
+    }
+    phase = at - (uint16_t)(STEPPER_TIMER->CCR[axis->config->ccr] - STEPPER_TIMER->R);
+    if (phase <= -STEPPER_STAGGER_GUARD)
+    {
+        return false;
+    }
+    if (phase > 0)
+    {
+        phase %= period;
+    }
+    if (phase < STEPPER_STAGGER_GUARD || period - phase < STEPPER_STAGGER_GUARD)
+    {
+        return true;
+    }
+
+    if (linearMove.active && axis == linearMove.major)
+    {
+        for (i = 0; i < axis->ramp.stride; i++)
+        {
+            edge = STEPPER_STAGGER_GUARD + i * minorStepSpacing(axis);
+            if (phase > edge - STEPPER_STAGGER_GUARD && phase < edge + STEPPER_STAGGER_GUARD)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/*!
+ * Sets the next compare of an axis \a period ticks after its last one. The
+ *  free running timer only spans 16 bits, so a longer period is split up:
+ *  the step ISR keeps waiting on intermediate compares until waitTicks runs
+ *  out. No chunk is ever shorter than STEPPER_MAX_INTERVAL, so the ISR always
+ *  has time to schedule the next one.
+ *
+ * \param axis   Axis to schedule
+ * \param period Ticks from the last compare to the next step
+ *
+ * \return None
+ */
+static void scheduleStep(StepperAxis *axis, uint32_t period)
+{
+    uint8_t ccr = axis->config->ccr;
+    uint16_t now;
+    uint32_t repay;
+    int32_t at, clear;
+
+    if (period > 0xFFFF)
+    {
+        axis->waitTicks = period - STEPPER_MAX_INTERVAL;
+        STEPPER_TIMER->CCR[ccr] += STEPPER_MAX_INTERVAL;
+        return;
+    }
+    axis->waitTicks = 0;
+
+    // Make up for earlier staggering, a quarter period at a time at most
+    repay = (axis->staggerDebt < period / 4) ? axis->staggerDebt : period / 4;
+    period -= repay;
+    axis->staggerDebt -= repay;
+
+    // One period after the last compare, which has already passed
+    now = STEPPER_TIMER->R;
+    at = (int32_t)period - (uint16_t)(now - STEPPER_TIMER->CCR[ccr]);
+    if (at < STEPPER_STAGGER_GUARD / 4)
+    {
+        // Running late, never set a compare the timer has already passed
+        at = STEPPER_STAGGER_GUARD / 4;
+    }
+    // Move the step edge clear of the other coil edges
+    clear = clearEdgeTime(at, ccr);
+    axis->staggerDebt += (uint32_t)(clear - at);
+    STEPPER_TIMER->CCR[ccr] = now + (uint16_t)clear;
+}
+
+/*!
+ * Drives the coils of an axis with its current sequence position again,
+ *  before it moves. Takes the axis away from the idle tick first, so the tick
+ *  can no longer turn its coils off.
+ *
+ * \param axis Axis about to move
+ *
+ * \return None
+ */
+static void energizeAxis(StepperAxis *axis)
+{
+    axis->idleCountdown = axis->idleDelay;
+    axis->coilState = COILS_FULL;
+    writeStep(axis);
+}
+
+/*!
+ * Checks whether an axis is at rest, neither stepping itself nor being
+ *  stepped as the minor axis of a linear move.
+ *
+ * \param axis Axis to check
+ *
+ * \return true if the axis is at rest
+ */
+static inline bool axisAtRest(const StepperAxis *axis)
+{
+    return !axis->ramp.running && !(linearMove.active && axis == linearMove.minor);
+}
+
+/*!
+ * Idle tick body, once per millisecond with the coils of chopping axes on,
+ *  and once more STEPPER_HOLD_DUTY percent later to turn them off again.
+ *
+ * \return None
+ */
+static void idleTick(void)
+{
+    bool chopping = false;
+    uint8_t i;
+
+    if (!idleChopOn)
+    {
+        // End of the on time within this tick
+        for (i = 0; i < NUM_STEPPERS; i++)
+        {
+            if (stepperAxes[i].coilState == COILS_CHOP)
+            {
+                writeCoils(&stepperAxes[i], 0);
+            }
+        }
+        STEPPER_TIMER->CCR[STEPPER_IDLE_CCR] += STEPPER_IDLE_TICK * (100 - STEPPER_HOLD_DUTY) / 100;
+        idleChopOn = true;
+        return;
+    }
+
+    for (i = 0; i < NUM_STEPPERS; i++)
+    {
+        StepperAxis *axis = &stepperAxes[i];
+
+        if (!axisAtRest(axis))
+        {
+            axis->idleCountdown = axis->idleDelay;
+        }
+        else if (axis->coilState == COILS_FULL && axis->idlePolicy != IDLE_HOLD)
+        {
+            if (axis->idleCountdown > 0)
+            {
+                axis->idleCountdown--;
+            }
+            else if (axis->idlePolicy == IDLE_CHOP)
+            {
+                axis->coilState = COILS_CHOP;
+            }
+            else
+            {
+                axis->coilState = COILS_OFF;
+                writeCoils(axis, 0);
+            }
+        }
+
+        switch (axis->coilState)
+        {
+        case COILS_FULL:
+            axis->coilLog.fullMs++;
+            break;
+        case COILS_CHOP:
+            axis->coilLog.chopMs++;
+            writeStep(axis);
+            chopping = true;
+            break;
+        default:
+            axis->coilLog.offMs++;
+            break;
+        }
+    }
+
+    idleChopping = chopping;
+    if (chopping)
+    {
+        STEPPER_TIMER->CCR[STEPPER_IDLE_CCR] += STEPPER_IDLE_TICK * STEPPER_HOLD_DUTY / 100;
+        idleChopOn = false;
+    }
+    else
+    {
+        STEPPER_TIMER->CCR[STEPPER_IDLE_CCR] += STEPPER_IDLE_TICK;
+    }
+}
+
+/*!
+ * Ends the linear move if \a axis is its major axis, however it stopped.
+ *  Minor axis steps still waiting for their compare are dropped, so a
+ *  stale one can never fire into the minor axis's own next move.
+ *
+ * \param axis Axis that stopped
+ *
+ * \return None
+ */
+static void endLinearMove(const StepperAxis *axis)
+{
+    StepperAxis *minor = linearMove.minor;
+
+    if (!linearMove.active || axis != linearMove.major)
+    {
+        return;
+    }
+    if (minor->deferredSteps > 0)
+    {
+        minor->deferredSteps = 0;
+        STEPPER_TIMER->CCTL[minor->config->ccr] &= ~(TIMER_A_CCTLN_CCIE);
+    }
+    linearMove.active = false;
+}
+
+/*!
+ * Stops an axis at once, used when it arrives at a limit or target
+ *  (already slowed to the pull-in rate by then).
+ *
+ * \param axis Axis to stop
+ *
+ * \return None
+ */
+static void haltAxis(StepperAxis *axis)
+{
+    STEPPER_TIMER->CCTL[axis->config->ccr] &= ~(TIMER_A_CCTLN_CCIE);
+    haltRamp(&axis->ramp);
+    endLinearMove(axis);
+}
+
+/*!
+ * Starts stepping an axis if it is not already stepping.
+ *
+ * \param axis Axis to start
+ *
+ * \return None
+ */
+static void startAxis(StepperAxis *axis)
+{
+    // Nothing to do if the axis is already stepping (or ramping down)
+    if (axis->ramp.running)
+    {
+        return;
+    }
+    // Never start into a limit
+    if (stepsToStop(axis, axis->ramp.requestedDirection) <= 0)
+    {
+        return;
+    }
+    energizeAxis(axis);
+    // Start from the pull-in rate and let the ISR accelerate from there
+    axis->ramp.stride = chooseStride(axis, stepsToStop(axis, axis->ramp.requestedDirection));
+    // First compare one period from now on the free running timer
+    STEPPER_TIMER->CCR[axis->config->ccr] = STEPPER_TIMER->R;
+    scheduleStep(axis, startRamp(&axis->ramp));
+    STEPPER_TIMER->CCTL[axis->config->ccr] = TIMER_A_CCTLN_CCIE;
+}
+
+/*!
+ * Moves the position and sequence of an axis on by \a steps DMA transfers
+ *  that have already been written to its port.
+ *
+ * \param axis  Axis stepped by the DMA
+ * \param steps Transfers completed
+ *
+ * \return None
+ */
+static void countDmaSteps(StepperAxis *axis, uint16_t steps)
+{
+    int32_t halfSteps = (int32_t)steps * axis->ramp.stride;
+
+    if (axis->ramp.direction == CW_DIR)
+    {
+        axis->currentStep = (axis->currentStep + halfSteps) & (STEP_SEQ_CNT - 1);
+    }
+    else
+    {
+        axis->currentStep = (axis->currentStep - halfSteps) & (STEP_SEQ_CNT - 1);
+    }
+    axis->position += (axis->ramp.direction == axis->config->homeDirection) ? -halfSteps : halfSteps;
+    if (axis->segmentSteps > 0)
+    {
+        axis->segmentSteps -= halfSteps;
+    }
+#ifdef STEPPER_BENCHMARK
+    axis->benchSteps += halfSteps;
+#endif
+}
+
+/*!
+ * Checks whether an axis is cruising steadily enough for the DMA to step it
+ *  for at least the next two blocks.
+ *
+ * \param axis Axis to check
+ *
+ * \return true if the DMA may step the axis
+ */
+static bool dmaCanStep(const StepperAxis *axis)
+{
+    const StepperRamp *ramp = &axis->ramp;
+
+    if (!axis->dmaAllowed || !ramp->running || ramp->direction != ramp->requestedDirection
+            || ramp->rate != ramp->targetRate || ramp->rate > ramp->limitRate
+            || ramp->period > 0xFFFF)
+    {
+        return false;
+    }
+    // The interpolator needs every step of both axes of a linear move
+    if (linearMove.active && (axis == linearMove.major || axis == linearMove.minor))
+    {
+        return false;
+    }
+    return stepsToStop(axis, ramp->direction)
+            > (int32_t)rampStopSteps(ramp) + 2 * STEPPER_DMA_BLOCK * ramp->stride;
+}
+
+/*!
+ * Hands a cruising axis over from its step interrupt to the DMA. Called from
+ *  the step ISR right after the next compare has been scheduled.
+ *
+ * \param axis Axis to hand over
+ *
+ * \return None
+ */
+static void enterDma(StepperAxis *axis)
+{
+    volatile uint8_t *out = axis->config->out;
+    uint8_t ccr = axis->config->ccr;
+    uint16_t elapsed = STEPPER_TIMER->R - (STEPPER_TIMER->CCR[ccr] - (uint16_t)axis->ramp.period);
+    uint8_t step = axis->currentStep;
+    uint16_t k;
+
+    // Too close to the next step to hand over in phase, try again then
+    if (elapsed >= axis->ramp.period - 1)
+    {
+        return;
+    }
+
+    for (k = 0; k < STEPPER_DMA_BLOCK; k++)
+    {
+        step = (axis->ramp.direction == CW_DIR) ? step + axis->ramp.stride : step - axis->ramp.stride;
+        dmaPattern[k] = axis->pattern[step & (STEP_SEQ_CNT - 1)];
+    }
+
+    DMA_PRIMARY(STEPPER_DMA_CHANNEL)->srcEnd = &dmaPattern[STEPPER_DMA_BLOCK - 1];
+    DMA_PRIMARY(STEPPER_DMA_CHANNEL)->dstEnd = out;
+    DMA_PRIMARY(STEPPER_DMA_CHANNEL)->control = STEPPER_DMA_CONTROL;
+    DMA_ALTERNATE(STEPPER_DMA_CHANNEL)->srcEnd = &dmaPattern[STEPPER_DMA_BLOCK - 1];
+    DMA_ALTERNATE(STEPPER_DMA_CHANNEL)->dstEnd = out;
+    DMA_ALTERNATE(STEPPER_DMA_CHANNEL)->control = STEPPER_DMA_CONTROL;
+    DMA_Control->ALTCLR = 1 << STEPPER_DMA_CHANNEL;
+    DMA_Control->ENASET = 1 << STEPPER_DMA_CHANNEL;
+
+    // Stop the compare interrupt and let Timer_A1 take over in phase: its
+    //  first CCR0 match lands where the next compare would have been
+    STEPPER_TIMER->CCTL[ccr] &= ~(TIMER_A_CCTLN_CCIE);
+    STEPPER_DMA_TIMER->CCR[0] = axis->ramp.period - 1;
+    STEPPER_DMA_TIMER->R = elapsed;
+    // Up Mode, source SMCLK, prescale 3:1 set up in initStepperMotors()
+    STEPPER_DMA_TIMER->CTL |= 0b0000000000010000;
+
+    axis->dmaActive = true;
+    dmaAxis = axis;
+}
+
+/*!
+ * Takes stepping of an axis back from the DMA, counting the transfers of
+ *  the block in progress, and resumes the step interrupt one period after
+ *  the last DMA step.
+ *
+ * \param axis Axis stepped by the DMA
+ *
+ * \return None
+ */
+static void leaveDma(StepperAxis *axis)
+{
+    uint8_t ccr = axis->config->ccr;
+    DmaControlEntry *active;
+    uint16_t elapsed;
+
+    // Stop Timer_A1 first so no transfer slips in while counting
+    STEPPER_DMA_TIMER->CTL &= 0b1111111111001111;
+    DMA_Control->ENACLR = 1 << STEPPER_DMA_CHANNEL;
+    elapsed = STEPPER_DMA_TIMER->R;
+
+    active = (DMA_Control->ALTSET & (1 << STEPPER_DMA_CHANNEL))
+                ? DMA_ALTERNATE(STEPPER_DMA_CHANNEL) : DMA_PRIMARY(STEPPER_DMA_CHANNEL);
+    countDmaSteps(axis, STEPPER_DMA_BLOCK - DMA_TRANSFERS_LEFT(active->control));
+    axis->driven = axis->pattern[axis->currentStep];
+
+    dmaAxis = 0;
+    axis->dmaActive = false;
+
+    STEPPER_TIMER->CCR[ccr] = STEPPER_TIMER->R + (uint16_t)(axis->ramp.period - elapsed);
+    axis->waitTicks = 0;
+    STEPPER_TIMER->CCTL[ccr] = TIMER_A_CCTLN_CCIE;
+}
+
+/*!
+ * Wakes the DMA interrupt of an axis being stepped by the DMA, so a new
+ *  speed, direction or segment is picked up without waiting for the block.
+ *
+ * \param axis Axis whose motion request changed
+ *
+ * \return None
+ */
+static void wakeAxis(StepperAxis *axis)
+{
+    if (axis->dmaActive)
+    {
+        NVIC->ISPR[STEPPER_DMA_IRQ >> 5] = 1 << (STEPPER_DMA_IRQ & 0x1F);
+    }
+}
+
+/*!
+ * Step interrupt body for one axis: advances one step in the ramp's
+ *  direction and schedules the next compare one period after this one.
+ *
+ * \param axis Axis whose compare register matched
+ *
+ * \return None
+ */
+static void stepperISR(StepperAxis *axis)
+{
+    uint8_t ccr = axis->config->ccr;
+    uint32_t nextPeriod;
+    int32_t remaining;
+#ifdef STEPPER_BENCHMARK
+    uint32_t start = readCycleCounter();
+    uint16_t lateness = STEPPER_TIMER->R - STEPPER_TIMER->CCR[ccr];
+
+    if (lateness > axis->worstLateness)
+    {
+        axis->worstLateness = lateness;
+    }
+#endif
+
+    // Minor axis steps of a linear move, a guard interval after the major.
+    //  One per compare, the rest spaced like the major axis's half-steps.
+    if (axis->deferredSteps > 0)
+    {
+        advanceAxis(axis, linearMove.minorDirection, 1);
+        if (--axis->deferredSteps > 0)
+        {
+            uint16_t now = STEPPER_TIMER->R;
+            int32_t at = minorStepSpacing(linearMove.major) - (uint16_t)(now - STEPPER_TIMER->CCR[ccr]);
+
+            if (at < STEPPER_STAGGER_GUARD / 4)
+            {
+                at = STEPPER_STAGGER_GUARD / 4;
+            }
+            STEPPER_TIMER->CCR[ccr] = now + (uint16_t)clearEdgeTime(at, ccr);
+        }
+        else
+        {
+            STEPPER_TIMER->CCTL[ccr] &= ~(TIMER_A_CCTLN_CCIE);
+        }
+        return;
+    }
+
+    // Part way through a long period. That is below the pull-in rate, so
+    //  a stop or a new speed or direction may cut the wait short.
+    if (axis->waitTicks > 0)
+    {
+        if (axis->ramp.targetRate == 0)
+        {
+            haltAxis(axis);
+            return;
+        }
+        if (axis->ramp.targetRate == axis->ramp.rate
+                && axis->ramp.requestedDirection == axis->ramp.direction)
+        {
+            scheduleStep(axis, axis->waitTicks);
+            return;
+        }
+        axis->waitTicks = 0;
+    }
+
+    // Never step past a soft limit or the target
+    if (stepsToStop(axis, axis->ramp.direction) <= 0)
+    {
+        // A linear move ends once the minor axis has taken its last steps
+        if (linearMove.active && axis == linearMove.major && linearMove.minor->deferredSteps > 0)
+        {
+            scheduleStep(axis, 2 * STEPPER_STAGGER_GUARD);
+            return;
+        }
+        haltAxis(axis);
+        return;
+    }
+
+    advanceAxis(axis, axis->ramp.direction, axis->ramp.stride);
+#ifdef STEPPER_BENCHMARK
+    axis->benchSteps += axis->ramp.stride;
+#endif
+
+    // Switch segments only between steps
+    if (axis->segmentSteps > 0)
+    {
+        axis->segmentSteps -= axis->ramp.stride;
+    }
+    serviceQueue(axis);
+
+    // A coordinated move steps the other axis from this interrupt too,
+    //  one Bresenham iteration per half-step of the major axis. Its steps
+    //  go out on its own compare a guard interval later, not on this edge.
+    if (linearMove.active && axis == linearMove.major)
+    {
+        StepperAxis *minor = linearMove.minor;
+        uint8_t minorCcr = minor->config->ccr;
+        uint8_t i;
+
+        for (i = 0; i < axis->ramp.stride; i++)
+        {
+            linearMove.error -= linearMove.minorSteps;
+            if (linearMove.error < 0)
+            {
+                linearMove.error += linearMove.majorSteps;
+                minor->deferredSteps++;
+            }
+        }
+        if (minor->deferredSteps > 0 && !(STEPPER_TIMER->CCTL[minorCcr] & TIMER_A_CCTLN_CCIE))
+        {
+            int32_t due = STEPPER_STAGGER_GUARD - (uint16_t)(STEPPER_TIMER->R - STEPPER_TIMER->CCR[ccr]);
+
+            // Never behind the timer, or the compare would wait a rollover
+            if (due < STEPPER_STAGGER_GUARD / 4)
+            {
+                due = STEPPER_STAGGER_GUARD / 4;
+            }
+            minor->waitTicks = 0;
+            STEPPER_TIMER->CCR[minorCcr] = STEPPER_TIMER->R + (uint16_t)due;
+            STEPPER_TIMER->CCTL[minorCcr] = TIMER_A_CCTLN_CCIE;
+        }
+    }
+
+    // Brake in time for the next limit or target in this direction
+    remaining = stepsToStop(axis, axis->ramp.direction);
+    if (remaining <= (int32_t)rampStopSteps(&axis->ramp))
+    {
+        setRampLimit(&axis->ramp, RAMP_PULL_IN_LIMIT);
+    }
+    else
+    {
+        setRampLimit(&axis->ramp, RAMP_NO_LIMIT);
+    }
+    axis->ramp.stride = chooseStride(axis, remaining);
+
+    // Time the next step relative to this compare so latency never
+    //  accumulates, or disarm the compare once decelerated to standstill
+    nextPeriod = rampNextPeriod(&axis->ramp);
+    if (nextPeriod == 0)
+    {
+        STEPPER_TIMER->CCTL[ccr] &= ~(TIMER_A_CCTLN_CCIE);
+        endLinearMove(axis);
+    }
+    else
+    {
+        scheduleStep(axis, nextPeriod);
+        // Hand steady cruising over to the DMA
+        if (axis->config->dedicatedPort && dmaAxis == 0 && dmaCanStep(axis))
+        {
+            enterDma(axis);
+        }
+    }
+
+#ifdef STEPPER_BENCHMARK
+    recordCycles(&axis->isrCycles, start);
+#endif
+}
+
+void initStepperMotors(void) {
+    uint8_t i;
+
+#ifdef STEPPER_BENCHMARK
+    initCycleCounter();
+#endif
+
+    for (i = 0; i < NUM_STEPPERS; i++)
+    {
+        StepperAxis *axis = &stepperAxes[i];
+        const StepperAxisConfig *config = &stepperConfig[i];
+
+        axis->config = config;
+        axis->currentStep = 0;
+        axis->stepMode = STEP_MODE_AUTO;
+        axis->position = 0;
+        axis->target = 0;
+        axis->seeking = false;
+        axis->homed = false;
+        axis->segmentSteps = 0;
+        axis->streaming = false;
+        axis->waitTicks = 0;
+        axis->staggerDebt = 0;
+        axis->deferredSteps = 0;
+        axis->idlePolicy = config->idlePolicy;
+        axis->idleDelay = STEPPER_IDLE_DELAY;
+        axis->idleCountdown = STEPPER_IDLE_DELAY;
+        axis->coilState = COILS_FULL;
+        axis->dmaAllowed = config->dedicatedPort;
+        axis->dmaActive = false;
+        initMotionQueue(&axis->queue);
+        buildPatterns(axis);
+
+        // set stepper port pins as GPIO outputs
+        *config->sel0 &= ~axis->mask;
+        *config->sel1 &= ~axis->mask;
+        *config->dir |= axis->mask;
+
+        // initialize stepper outputs to LOW
+        *config->out &= ~axis->mask;
+        axis->driven = 0;
+
+        // Start at standstill with the default acceleration profile
+        initRamp(&axis->ramp, RAMP_MAX_ACCEL, RAMP_JERK, config->initDirection);
+
+        // Compare mode with interrupt disabled until the axis is enabled
+        STEPPER_TIMER->CCTL[config->ccr] = 0;
+        ccrAxis[config->ccr] = axis;
+    }
+
+    // Idle tick, first one a tick after the timer starts
+    STEPPER_TIMER->CCR[STEPPER_IDLE_CCR] = STEPPER_IDLE_TICK;
+    STEPPER_TIMER->CCTL[STEPPER_IDLE_CCR] = TIMER_A_CCTLN_CCIE;
+    idleChopOn = true;
+
+    // Configure Timer_A3 in Continuous Mode, with source SMCLK, prescale 3:1,
+    //  and overflow interrupt disabled  -  tick rate will be 4MHz (for
+    //  SMCLK = 12MHz). The timer keeps running, axes start and stop by
+    //  arming and disarming their own compare registers.
+    STEPPER_TIMER->EX0 = 0b0000000000000010;
+    STEPPER_TIMER->CTL = 0b0000001000100100;
+
+    // Enable TA3 CCR1-CCR4 and CCR0 interrupts by setting IRQ bits in NVIC
+    //  ISER register. Both keep the default priority, so the idle tick and
+    //  the steps never interrupt each other.
+    NVIC->ISER[STEPPER_TIMER_IRQ >> 5] = 1 << (STEPPER_TIMER_IRQ & 0x1F);
+    NVIC->ISER[STEPPER_IDLE_IRQ >> 5] = 1 << (STEPPER_IDLE_IRQ & 0x1F);
+
+    // Configure Timer_A1 for DMA stepping, stopped with source SMCLK and
+    //  prescale 3:1 like Timer_A3. CCR0 only triggers the DMA, no interrupt.
+    STEPPER_DMA_TIMER->CTL = 0b0000001000000100;
+    STEPPER_DMA_TIMER->EX0 = 0b0000000000000010;
+    STEPPER_DMA_TIMER->CCTL[0] = 0;
+
+    // Route TA1CCR0 to the DMA channel and its block completions to DMA_INT1
+    DMA_Channel->CH_SRCCFG[STEPPER_DMA_CHANNEL] = STEPPER_DMA_SOURCE;
+    DMA_Channel->INT1_SRCCFG = DMA_INT1_SRCCFG_EN | STEPPER_DMA_CHANNEL;
+    NVIC->ISER[STEPPER_DMA_IRQ >> 5] = 1 << (STEPPER_DMA_IRQ & 0x1F);
 
     __enable_irq();                             // Enable global interrupt
 }
 
-void enableStepperMotor(void) {
-    // Configure Timer_A3 in Up Mode (leaving remaining configuration unchanged)
-    TIMER_A3->CTL &= 0b1111111111011111;
-    TIMER_A3->CTL |= 0b0000000000010000;
+void enableStepperMotor(uint8_t axis) {
+    // Free running, only the soft limits stop the axis
+    stepperAxes[axis].seeking = false;
+    startAxis(&stepperAxes[axis]);
 }
 
-void disableStepperMotor(void) {
-    // For driver use
-    //  Configure Timer_A3 in Stop Mode (leaving remaining configuration unchanged)
-    TIMER_A3->CTL &= 0b1111111111001111;
+void disableStepperMotor(uint8_t axis) {
+    // Drop queued segments first so the ISR cannot pick up another one
+    discardMotionSegments(&stepperAxes[axis].queue);
+    // Decelerate to a stop, the ISR disarms the compare once slow enough
+    setRampTarget(&stepperAxes[axis].ramp, 0);
+    wakeAxis(&stepperAxes[axis]);
 }
 
-void stepClockwise(void) {
-    currentStep = (currentStep + 1) % STEP_SEQ_CNT;  // increment to next step position
-    // Update output port for current step pattern
-    //  do this as a single assignment to avoid transient changes on driver signals
-    //STEPPER_PORT->OUT = (STEPPER_PORT->OUT & 0x0F) + (stepperSequence[currentStep] << 4);
-    STEPPER_PORT->OUT = (STEPPER_PORT->OUT & 0b00010111) + ((stepperSequence[currentStep] << 4) & 0b11100000) + (stepperSequence[currentStep] << 3 & 0b00001000);
+void stepClockwise(uint8_t axis) {
+    StepperAxis *a = &stepperAxes[axis];
+
+    a->currentStep = (a->currentStep + 1) & (STEP_SEQ_CNT - 1);  // increment to next step position
+    writeStep(a);
 }
 
-void stepCounterClockwise(void) {
-    currentStep = ((uint8_t)(currentStep - 1)) % STEP_SEQ_CNT;  // decrement to previous step position (counter-clockwise)
-    // For future driver use
-    //  update output port for current step pattern
-    //  do this as a single assignment to avoid transient changes on driver signals
-    STEPPER_PORT->OUT = (STEPPER_PORT->OUT & 0b00010111) + ((stepperSequence[currentStep] << 4) & 0b11100000) + (stepperSequence[currentStep] << 3 & 0b00001000);
+void stepCounterClockwise(uint8_t axis) {
+    StepperAxis *a = &stepperAxes[axis];
+
+    a->currentStep = (a->currentStep - 1) & (STEP_SEQ_CNT - 1);  // decrement to previous step position
+    writeStep(a);
+}
+
+// Timer A3 CCR1-CCR4 interrupt service routine
+void TA3_N_IRQHandler(void)
+{
+    uint16_t vector;
+
+    // Reading TA3IV clears the highest priority pending flag, keep going
+    //  until every axis whose compare matched has been stepped
+    while ((vector = STEPPER_TIMER->IV) != 0)
+    {
+        uint8_t ccr = vector >> 1;
+
+        if (ccr <= MAX_STEPPERS && ccrAxis[ccr] != 0)
+        {
+            stepperISR(ccrAxis[ccr]);
+        }
+    }
 }
 
-// Timer A3 CCR0 interrupt service routine
+// Timer A3 CCR0 interrupt service routine, the flag clears on entry
 void TA3_0_IRQHandler(void)
 {
-    /* Not necessary to check which flag is set because only one IRQ
-     *  mapped to this interrupt vector     */
-    if (clockWise)
+    idleTick();
+}
+
+// DMA block completion interrupt service routine
+void DMA_INT1_IRQHandler(void)
+{
+    StepperAxis *axis = dmaAxis;
+#ifdef STEPPER_BENCHMARK
+    uint32_t start = readCycleCounter();
+#endif
+
+    // Also pended by wakeAxis() when the motion request changes
+    if (axis == 0)
     {
-        stepClockwise();
+        return;
     }
-    else
+
+    // Refill whichever structure has finished, the other one keeps stepping
+    if ((DMA_PRIMARY(STEPPER_DMA_CHANNEL)->control & DMA_MODE_MASK) == DMA_MODE_STOP)
     {
-        stepCounterClockwise();
+        countDmaSteps(axis, STEPPER_DMA_BLOCK);
+        DMA_PRIMARY(STEPPER_DMA_CHANNEL)->control = STEPPER_DMA_CONTROL;
     }
-    // Clear timer compare flag in TA3CCTL0
-    TIMER_A3->CCTL[0] &= ~(TIMER_A_CCTLN_CCIFG);
+    if ((DMA_ALTERNATE(STEPPER_DMA_CHANNEL)->control & DMA_MODE_MASK) == DMA_MODE_STOP)
+    {
+        countDmaSteps(axis, STEPPER_DMA_BLOCK);
+        DMA_ALTERNATE(STEPPER_DMA_CHANNEL)->control = STEPPER_DMA_CONTROL;
+    }
+
+    serviceQueue(axis);
+    if (!dmaCanStep(axis))
+    {
+        leaveDma(axis);
+    }
+
+#ifdef STEPPER_BENCHMARK
+    recordCycles(&axis->isrCycles, start);
+#endif
 }
 
-void setDirection(int dir)
+void setDirection(uint8_t axis, int dir)
 {
     if (dir == CW_DIR)
     {
-        clockWise = 1;
+        setRampDirection(&stepperAxes[axis].ramp, CW_DIR);
     }
     else
     {
-        clockWise = 0;
+        setRampDirection(&stepperAxes[axis].ramp, CCW_DIR);
     }
+    wakeAxis(&stepperAxes[axis]);
 }
 
-void toggleDirection(void)
+void toggleDirection(uint8_t axis)
 {
-    if (clockWise)
+    if (stepperAxes[axis].ramp.requestedDirection == CW_DIR)
     {
-        clockWise = 0;
+        setRampDirection(&stepperAxes[axis].ramp, CCW_DIR);
     }
     else
     {
-        clockWise = 1;
+        setRampDirection(&stepperAxes[axis].ramp, CW_DIR);
+    }
+    wakeAxis(&stepperAxes[axis]);
+}
+
+void setStepMode(uint8_t axis, uint8_t mode)
+{
+    // Picked up by chooseStride() when the next step is timed
+    stepperAxes[axis].stepMode = mode;
+    wakeAxis(&stepperAxes[axis]);
+}
+
+void setStepperIdle(uint8_t axis, uint8_t policy, uint16_t delayMs)
+{
+    StepperAxis *a = &stepperAxes[axis];
+
+    a->idlePolicy = policy;
+    a->idleDelay = delayMs;
+    // Re-applied by the idle tick once the new delay has passed
+    if (axisAtRest(a))
+    {
+        energizeAxis(a);
+    }
+}
+
+void setStepperDma(uint8_t axis, bool allow)
+{
+    stepperAxes[axis].dmaAllowed = allow && stepperAxes[axis].config->dedicatedPort;
+    wakeAxis(&stepperAxes[axis]);
+}
+
+void setStepPeriod(uint8_t axis, uint32_t period)
+{
+    // Target period, the ISR ramps the compare interval towards it step by step
+    setRampTarget(&stepperAxes[axis].ramp, period);
+    wakeAxis(&stepperAxes[axis]);
+}
+
+void moveStepperTo(uint8_t axis, int32_t target, uint32_t period)
+{
+    StepperAxis *a = &stepperAxes[axis];
+
+    if (a->homed)
+    {
+        target = (target < 0) ? 0 : (target > a->config->travel) ? a->config->travel : target;
+    }
+    a->target = target;
+    a->seeking = true;
+
+    if (a->position == target)
+    {
+        return;
+    }
+    setRampDirection(&a->ramp, (target < a->position) ? a->config->homeDirection : !a->config->homeDirection);
+    setRampTarget(&a->ramp, period);
+    wakeAxis(a);
+    startAxis(a);
+}
+
+bool queueStepperSegment(uint8_t axis, int8_t direction, uint32_t period, uint32_t steps)
+{
+    StepperAxis *a = &stepperAxes[axis];
+
+    if (!pushMotionSegment(&a->queue, direction, period, steps))
+    {
+        return false;
+    }
+
+    // Checked after the push: a running ISR either picks the segment up or
+    //  has already stopped the axis and left it to be started here
+    if (!a->ramp.running)
+    {
+        a->seeking = false;
+        a->segmentSteps = 0;
+        // Skip segments that would start into a soft limit
+        do
+        {
+            serviceQueue(a);
+            startAxis(a);
+        } while (!a->ramp.running && motionSegmentsQueued(&a->queue) > 0);
+    }
+    return true;
+}
+
+uint8_t stepperSegmentsQueued(uint8_t axis)
+{
+    return motionSegmentsQueued(&stepperAxes[axis].queue);
+}
+
+bool stepperAtTarget(uint8_t axis)
+{
+    StepperAxis *a = &stepperAxes[axis];
+
+    return a->seeking && !a->ramp.running && a->position == a->target;
+}
+
+bool stepperAtRest(uint8_t axis)
+{
+    StepperAxis *a = &stepperAxes[axis];
+
+    return axisAtRest(a) && !(STEPPER_TIMER->CCTL[a->config->ccr] & TIMER_A_CCTLN_CCIE);
+}
+
+void setStepperHome(uint8_t axis)
+{
+    stepperAxes[axis].position = 0;
+    stepperAxes[axis].homed = true;
+}
+
+bool stepperHomed(uint8_t axis)
+{
+    return stepperAxes[axis].homed;
+}
+
+bool moveSteppersLinear(int32_t dx, int32_t dy, uint32_t period)
+{
+    StepperAxis *x = &stepperAxes[STEPPER_X];
+    StepperAxis *y = &stepperAxes[STEPPER_Y];
+    int32_t ax, ay;
+
+    // Both axes must be at rest, the minor axis's own compare stays off
+    if (linearMove.active || x->ramp.running || y->ramp.running)
+    {
+        return false;
+    }
+
+    // Clamp the end point to the soft limits
+    if (x->homed)
+    {
+        dx = (x->position + dx < 0) ? -x->position
+                : (x->position + dx > x->config->travel) ? x->config->travel - x->position : dx;
+    }
+    if (y->homed)
+    {
+        dy = (y->position + dy < 0) ? -y->position
+                : (y->position + dy > y->config->travel) ? y->config->travel - y->position : dy;
+    }
+    ax = (dx < 0) ? -dx : dx;
+    ay = (dy < 0) ? -dy : dy;
+    if (ax == 0 && ay == 0)
+    {
+        return true;
+    }
+
+    if (ax >= ay)
+    {
+        linearMove.major = x;
+        linearMove.minor = y;
+        linearMove.majorSteps = ax;
+        linearMove.minorSteps = ay;
+        linearMove.minorDirection = (dy < 0) ? y->config->homeDirection : !y->config->homeDirection;
+    }
+    else
+    {
+        linearMove.major = y;
+        linearMove.minor = x;
+        linearMove.majorSteps = ay;
+        linearMove.minorSteps = ax;
+        linearMove.minorDirection = (dx < 0) ? x->config->homeDirection : !x->config->homeDirection;
+    }
+    linearMove.error = linearMove.majorSteps / 2;
+    linearMove.minor->seeking = false;
+    linearMove.active = true;
+    energizeAxis(linearMove.minor);
+
+    moveStepperTo((linearMove.major == x) ? STEPPER_X : STEPPER_Y,
+                  linearMove.major->position + ((linearMove.major == x) ? dx : dy), period);
+    return true;
+}
+
+bool stepperEdgeNear(uint16_t offset)
+{
+    uint8_t i;
+
+    if (clearEdgeTime(offset, STEPPER_NO_CCR) != offset)
+    {
+        return true;
+    }
+    for (i = 0; i < NUM_STEPPERS; i++)
+    {
+        if (projectedEdgeNear(&stepperAxes[i], offset))
+        {
+            return true;
+        }
     }
+    return false;
 }
 
-void setRPM(double RPM)
+bool linearMoveActive(void)
 {
-    stepPeriod = CLK_RATE * SEC_PER_MIN / (RPM * STEPS_PER_REV);
-    TIMER_A3->CCR[0] = stepPeriod;
+    return linearMove.active;
 }
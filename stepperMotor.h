@@ -3,7 +3,25 @@
  * stepperMotor.h
  *
  * Description: Stepper motor ULN2003 driver for MSP432P4111 Launchpad.
- *              Uses Timer_A3 and P2.7, P2.6, P2.5, P2.3
+ *              Drives every axis listed in the descriptor table in
+ *              stepperMotor.c from Timer_A3 in continuous mode, with one
+ *              compare register (CCR1 to CCR4) per axis:
+ *                  STEPPER_X - TA3 CCR1 and P2.7, P2.6, P2.5, P2.3
+ *                  STEPPER_Y - TA3 CCR2 and P6.7, P6.6, P6.5, P6.4
+ *
+ *              An axis whose port has no other GPIO outputs can hand
+ *              cruising over to the uDMA, which copies precomputed port
+ *              bytes to PxOUT on every Timer_A1 CCR0 match. The CPU then
+ *              only wakes once per STEPPER_DMA_BLOCK steps.
+ *
+ *              TA3 CCR0 ticks every millisecond, on its own interrupt, to
+ *              apply the idle policy of axes at rest and to log how long
+ *              their coils are driven.
+ *
+ *              Coil switching edges are staggered: every step is scheduled
+ *              at least STEPPER_STAGGER_GUARD away from the edges already
+ *              scheduled on the other compares and by the DMA, and the delay
+ *              is made up over the following steps.
  *
  *  Created on: 01/09/2023
  *      Author: Vineet Ranade & Yao Xiong
@@ -24,63 +42,217 @@ extern "C"
 #endif
 
 #include "msp.h"
+#include <stdbool.h>
+#include "stepperRamp.h"
+#include "motionQueue.h"
+#include "dma.h"
+#include "cycleCounter.h"
+#include "gpio.h"
 
+/* Horizontal axis pins */
 #define STEPPER_PORT                    P2
-#define STEPPER_MASK                    (0x00E8)
 #define STEPPER_IN1                     (0x0080)
 #define STEPPER_IN2                     (0x0040)
 #define STEPPER_IN3                     (0x0020)
 #define STEPPER_IN4                     (0x0008)
 
+/* Vertical axis pins */
+#define STEPPER_PORT2                   P6
+#define STEPPER_IN12                    (0x0080)
+#define STEPPER_IN22                    (0x0040)
+#define STEPPER_IN32                    (0x0020)
+#define STEPPER_IN42                    (0x0010)
+
+#define STEPPER_X                       0       // Horizontal axis
+#define STEPPER_Y                       1       // Vertical axis
+#define NUM_STEPPERS                    2
+#define MAX_STEPPERS                    4       // CCR1 to CCR4 of STEPPER_TIMER
+
+#define STEPPER_TIMER                   TIMER_A3
+#define STEPPER_TIMER_IRQ               TA3_N_IRQn
+#define STEPPER_IDLE_IRQ                TA3_0_IRQn
+
+/* Idle coil policies, see setStepperIdle() */
+#define IDLE_HOLD                       0       // Keep full current on the last step
+#define IDLE_CHOP                       1       // Chop the hold current to STEPPER_HOLD_DUTY
+#define IDLE_OFF                        2       // De-energize all coils
+
+#define STEPPER_IDLE_CCR                0       // Idle tick on TA3 CCR0, free in continuous mode
+#define STEPPER_NO_CCR                  0xFF    // No compare register
+#define STEPPER_IDLE_TICK               (CLK_RATE / 1000)   // 1ms
+#define STEPPER_HOLD_DUTY               25      // Percent of each tick coils are on when chopping
+#define STEPPER_IDLE_DELAY              500     // Time at rest before the policy applies (ms)
+
+/* Edge staggering */
+#define STEPPER_STAGGER_GUARD           200     // Minimum gap between coil edges (50us)
+
+/* Coil drive states */
+#define COILS_FULL                      0
+#define COILS_CHOP                      1
+#define COILS_OFF                       2
+
+/* DMA stepping, one axis at a time */
+#define STEPPER_DMA_TIMER               TIMER_A1
+#define STEPPER_DMA_CHANNEL             2       // Channel 2 ...
+#define STEPPER_DMA_SOURCE              6       // ... triggered by TA1CCR0
+#define STEPPER_DMA_IRQ                 DMA_INT1_IRQn
+#define STEPPER_DMA_BLOCK               64      // Steps per DMA block, multiple of STEP_SEQ_CNT
+
 #define INIT_PERIOD                     10000
 #define CLK_RATE                        4000000
 #define STEPS_PER_REV                   32*64*2
 #define SEC_PER_MIN                     60
 #define STEP_SEQ_CNT                    8
+#define STEP_COILS                      4
 #define MIN_RPM                         1
 #define MAX_RPM                         15
 #define CW_DIR                          1
 #define CCW_DIR                         0
 
+/* Step modes, see setStepMode() */
+#define STEP_MODE_HALF                  0       // Alternating one and two coils, 8 positions
+#define STEP_MODE_FULL                  1       // Two coils on, even sequence positions
+#define STEP_MODE_WAVE                  2       // One coil on, odd sequence positions
+#define STEP_MODE_AUTO                  3       // Half-step when slow, full-step when fast
+
+// STEP_MODE_AUTO switches to full-step above, and back to half-step below,
+//  these rates in half-steps per second
+#define STEP_AUTO_FULL_ABOVE            1000
+#define STEP_AUTO_HALF_BELOW            800
+
+// Soft travel limits, in half-steps away from the home position
+#define STEPPER_X_TRAVEL                13000
+#define STEPPER_Y_TRAVEL                13000
+#define STEPS_UNLIMITED                 0x7FFFFFFF
+
+// Step period in timer ticks for a speed in RPM, or in thousandths of an RPM
+//  for slow creep (periods longer than the 16-bit timer are fine)
+#define RPM_TO_PERIOD(rpm)              (CLK_RATE * SEC_PER_MIN / ((rpm) * STEPS_PER_REV))
+#define MILLIRPM_TO_PERIOD(mrpm)        ((uint32_t)(1000ULL * CLK_RATE * SEC_PER_MIN \
+                                            / ((mrpm) * STEPS_PER_REV)))
+
+// Longest gap between two compares of one axis, longer step periods are
+//  waited out over several compares
+#define STEPPER_MAX_INTERVAL            0x8000
+
+/*!
+ * Compile-time description of one stepper axis
+ */
+typedef struct
+{
+    volatile uint8_t *out;          // Port OUT register
+    volatile uint8_t *dir;          // Port DIR register
+    volatile uint8_t *sel0;         // Port SEL0 register
+    volatile uint8_t *sel1;         // Port SEL1 register
+    uint8_t pins[STEP_COILS];       // Port bits driving IN1 to IN4
+    uint8_t ccr;                    // STEPPER_TIMER compare register (1 to MAX_STEPPERS)
+    bool dedicatedPort;             // No other outputs on the port, written whole and by the DMA
+    uint8_t idlePolicy;             // IDLE_x applied after initialization
+    int8_t initDirection;           // Direction after initialization
+    int8_t homeDirection;           // Direction that moves towards home
+    int32_t travel;                 // Soft limit furthest from home (steps)
+} StepperAxisConfig;
+
+/*!
+ * Time an axis has spent in each coil drive state, for checking how much
+ *  current the idle policy saves. Coils draw about fullMs +
+ *  chopMs * STEPPER_HOLD_DUTY / 100 milliseconds worth of full current.
+ */
+typedef struct
+{
+    uint32_t fullMs;                // Coils driven at full current
+    uint32_t chopMs;                // Coils chopped to the hold duty
+    uint32_t offMs;                 // Coils de-energized
+} CoilLog;
+
+/*!
+ * Run-time state of one stepper axis
+ */
+typedef struct
+{
+    const StepperAxisConfig *config;
+    uint8_t mask;                   // All coil bits of the port
+    uint8_t pattern[STEP_SEQ_CNT];  // Port bits for each sequence position
+    uint8_t driven;                 // Coil bits currently on the port
+    volatile uint32_t *coilBit[STEP_COILS]; // Bit-band aliases of IN1 to IN4 on a shared port
+    uint8_t currentStep;            // Position in the step sequence
+    uint8_t stepMode;               // Requested STEP_MODE_x
+    StepperRamp ramp;               // Step rate and direction
+    volatile int32_t position;      // Steps away from home, kept by the step ISR
+    int32_t target;                 // Position to stop at when seeking
+    bool seeking;                   // Moving to target rather than free running
+    bool homed;                     // Position is known, soft limits active
+    MotionQueue queue;              // Segments waiting for the step ISR
+    int32_t segmentSteps;           // Half-steps left in the segment being run
+    bool streaming;                 // Following segments from the queue
+    uint32_t waitTicks;             // Rest of a long period still to wait out
+    uint32_t staggerDebt;           // Ticks steps were pushed back, made up later
+    uint8_t deferredSteps;          // Linear move minor steps due at the next compare
+    uint8_t idlePolicy;             // IDLE_x once at rest for idleDelay
+    uint16_t idleDelay;             // Time at rest before the idle policy applies (ms)
+    uint16_t idleCountdown;         // Milliseconds left before the idle policy applies
+    volatile uint8_t coilState;     // COILS_x
+    CoilLog coilLog;                // Time spent in each coil state
+    bool dmaAllowed;                // Cruise with DMA stepping when possible
+    volatile bool dmaActive;        // Currently stepped by the DMA
+#ifdef STEPPER_BENCHMARK
+    // MCLK cycles per half-step are isrCycles.total / benchSteps. Read them
+    //  in the debugger after a fixed-speed move of a known number of steps.
+    CycleStats isrCycles;           // Cycles spent in the step and DMA ISRs
+    uint32_t benchSteps;            // Half-steps taken, for cycles per step
+    uint16_t worstLateness;         // Longest delay from compare to ISR (ticks)
+#endif
+} StepperAxis;
+
+extern StepperAxis stepperAxes[NUM_STEPPERS];
+
 /*!
- * \brief This function configures pins and timer for stepper motor driver
+ * \brief This function configures pins and timers for all stepper axes
  *
- * This function configures P2.3, P2.5, P2.6, and P2.6 as output pins
- *  for the ULN2003 stepper driver IN port, and initializes Timer_A3 to
- *  increment step position with compare interrupt
+ * This function configures the coil pins of every axis as outputs for the
+ *  ULN2003 stepper driver IN port, precomputes the port output for each
+ *  step sequence position, and starts Timer_A3 free running so each axis
+ *  can schedule its steps on its own compare register
  *
- * Modified bits 3, 5, 6, and 7 of \b P2DIR register and \b P2SEL registers.
- * Modified \b TA3CTL register and \b TA3CCTL0 registers.
+ * Modified coil bits of the \b PxDIR, \b PxSEL and \b PxOUT registers.
+ * Modified \b TA3CTL, \b TA3EX0 and \b TA3CCTLn registers.
  *
  * \return None
  */
-extern void initStepperMotor(void);
+extern void initStepperMotors(void);
 
 
 /*!
- * \brief This starts stepper motor rotation by turning on Timer_A3
+ * \brief This starts stepper motor rotation by arming its compare register
  *
- * This function starts stepper motor rotation by turning on Timer_A3.
- * Assumes stepper motor has already been configured by initStepperMotor().
+ * Rotation starts at the pull-in rate and accelerates towards the speed set
+ *  by setStepPeriod(). Assumes stepper motors have already been configured by
+ *  initStepperMotors().
  *
- * Modified \b TA3CTL register.
+ * Modified \b TA3CCTLn and \b TA3CCRn registers.
+ *
+ * \param axis Axis to start (STEPPER_X or STEPPER_Y)
  *
  * \return None
  */
-extern void enableStepperMotor(void);
+extern void enableStepperMotor(uint8_t axis);
 
 
 /*!
- * \brief This stops stepper motor rotation by turning off timer
+ * \brief This stops stepper motor rotation by disarming its compare register
+ *
+ * This function decelerates the stepper motor, and its compare interrupt is
+ *  turned off from the ISR once the motor is slow enough to stop without
+ *  losing steps. Segments queued with queueStepperSegment() are discarded.
+ *  Stepper motor is still configured after calling this function.
  *
- * This function stops stepper motor rotation by turning off Timer_A3.
- * Stepper motor is still configured after calling this function.
+ * Modified \b TA3CCTLn register.
  *
- * Modified \b TA3CTL register.
+ * \param axis Axis to stop
  *
  * \return None
  */
-extern void disableStepperMotor(void);
+extern void disableStepperMotor(uint8_t axis);
 
 
 /*!
@@ -88,11 +260,13 @@ extern void disableStepperMotor(void);
  *
  * This function increments to next clockwise step position
  *
- * Modified bit 3, 5, 6, and 7 of \b P2OUT register.
+ * Modified coil bits of \b PxOUT register.
+ *
+ * \param axis Axis to step
  *
  * \return None
  */
-extern void stepClockwise(void);
+extern void stepClockwise(uint8_t axis);
 
 
 /*!
@@ -100,33 +274,222 @@ extern void stepClockwise(void);
  *
  * This function increments to next counter-clockwise step position
  *
- * Modified bit 3, 5, 6, and 7 of \b P2OUT register.
+ * Modified coil bits of \b PxOUT register.
+ *
+ * \param axis Axis to step
  *
  * \return None
  */
-extern void stepCounterClockwise(void);
+extern void stepCounterClockwise(uint8_t axis);
 
 /*!
  * \brief Changes direction of stepper motor
  *
  * This function changes from clockwise to counter-clockwise or vice-versa
  *
+ * \param axis Axis to reverse
+ *
  * \return None
  */
-extern void toggleDirection(void);
+extern void toggleDirection(uint8_t axis);
+
+/*!
+ * \brief Sets direction of stepper motor
+ *
+ * \param axis Axis to change
+ * \param dir  CW_DIR or CCW_DIR
+ *
+ * \return None
+ */
+extern void setDirection(uint8_t axis, int dir);
+
+/*!
+ * \brief Selects how an axis walks the step sequence
+ *
+ * Full and wave drive move two sequence positions per timer period, so the
+ *  axis travels twice as fast for the same interrupt rate. Positions are
+ *  always counted in half-steps, and a single half-step is inserted where
+ *  needed to line up with the new mode, so nothing is lost when switching.
+ *  The change takes effect from the next step, even while moving.
+ *
+ * \param axis Axis to change
+ * \param mode STEP_MODE_HALF, STEP_MODE_FULL, STEP_MODE_WAVE or STEP_MODE_AUTO
+ *
+ * \return None
+ */
+extern void setStepMode(uint8_t axis, uint8_t mode);
+
+/*!
+ * \brief Queues a motion segment for the step interrupt to run
+ *
+ * The step interrupt starts the segment once the previous one has taken its
+ *  steps, ramping towards \a period and reversing through the pull-in rate if
+ *  needed, so direction and speed never change in the middle of a step. An
+ *  axis at rest is started right away. Once the queue runs dry the axis
+ *  decelerates to a stop, so keep at least one segment queued for smooth
+ *  motion. Do not mix with the other motion calls without calling
+ *  disableStepperMotor() first.
+ *
+ * \param axis      Axis to move
+ * \param direction CW_DIR or CCW_DIR
+ * \param period    Target time per half-step in timer ticks
+ * \param steps     Half-steps to take before the next segment starts
+ *
+ * \return false if the queue is full and the segment was dropped
+ */
+extern bool queueStepperSegment(uint8_t axis, int8_t direction, uint32_t period, uint32_t steps);
+
+/*!
+ * \brief Counts the segments queued for an axis but not started yet
+ *
+ * \param axis Axis to check
+ *
+ * \return Number of queued segments
+ */
+extern uint8_t stepperSegmentsQueued(uint8_t axis);
 
-extern void setDirection(int dir);
+/*!
+ * \brief Sets what an axis does with its coils while at rest
+ *
+ * Once the axis has been at rest for \a delayMs, IDLE_CHOP drives the last
+ *  step pattern for STEPPER_HOLD_DUTY percent of every millisecond and
+ *  IDLE_OFF turns all coils off. The next move drives the same pattern again
+ *  before its first step, so the sequence position carries on without a
+ *  jump.
+ *
+ * \param axis    Axis to change
+ * \param policy  IDLE_HOLD, IDLE_CHOP or IDLE_OFF
+ * \param delayMs Time at rest before the policy applies
+ *
+ * \return None
+ */
+extern void setStepperIdle(uint8_t axis, uint8_t policy, uint16_t delayMs);
+
+/*!
+ * \brief Allows an axis to cruise with DMA stepping
+ *
+ * While the axis runs at a constant speed, in one direction and well away
+ *  from its target or limits, the step interrupt hands stepping over to the
+ *  uDMA. Any change of speed or direction hands it back at once. Segments
+ *  queued with queueStepperSegment() switch at block boundaries while the DMA
+ *  is stepping. Ignored for axes whose port is shared with other outputs.
+ *  With STEPPER_BENCHMARK, running the same cruise with \a allow true and
+ *  false shows the CPU time it saves, see isrCycles.
+ *
+ * \param axis  Axis to change
+ * \param allow true to use DMA stepping when possible
+ *
+ * \return None
+ */
+extern void setStepperDma(uint8_t axis, bool allow);
+
+/*!
+ * \brief Moves a stepper axis to an absolute position
+ *
+ * The axis turns towards \a target, accelerating up to \a period and
+ *  decelerating in time to stop exactly on the target. Calling it again
+ *  with the same target while moving has no effect. The target is clamped
+ *  to the soft travel limits.
+ *
+ * \param axis   Axis to move
+ * \param target Position in steps away from home
+ * \param period Cruise step period in timer ticks
+ *
+ * \return None
+ */
+extern void moveStepperTo(uint8_t axis, int32_t target, uint32_t period);
+
+/*!
+ * \brief Checks whether an axis has stopped on the target of moveStepperTo()
+ *
+ * \param axis Axis to check
+ *
+ * \return true once the axis is at rest on its target
+ */
+extern bool stepperAtTarget(uint8_t axis);
+
+/*!
+ * \brief Checks whether an axis is at rest
+ *
+ * \param axis Axis to check
+ *
+ * \return true if the axis is neither stepping nor being stepped by a
+ *  linear move, and its step compare is disarmed
+ */
+extern bool stepperAtRest(uint8_t axis);
+
+/*!
+ * \brief Moves both axes in a straight line
+ *
+ * Runs a Bresenham interpolator from the step interrupt of the axis with
+ *  the longer distance, which also steps the other axis, so both arrive at
+ *  the same time. The major axis accelerates up to \a period and brakes
+ *  onto the end point. The end point is clamped to the soft travel limits.
+ *
+ * \param dx     Horizontal distance in steps, positive away from home
+ * \param dy     Vertical distance in steps, positive away from home
+ * \param period Cruise step period of the major axis in timer ticks
+ *
+ * \return false if an axis is still moving and the move was not started
+ */
+extern bool moveSteppersLinear(int32_t dx, int32_t dy, uint32_t period);
+
+/*!
+ * \brief Checks whether a move started by moveSteppersLinear() is running
+ *
+ * \return true until the major axis has stopped on the end point
+ */
+extern bool linearMoveActive(void);
+
+/*!
+ * \brief Checks whether a stepper coil edge is scheduled close to a moment
+ *
+ * Lets other drivers keep their own switching away from the step edges.
+ *  Scheduled edges are the next step of every axis, the DMA step train and
+ *  the chopped hold. Steps further out are projected from the current
+ *  period of each axis, so they are only exact while it cruises.
+ *
+ * \param offset Moment to check, in STEPPER_TIMER ticks from now
+ *
+ * \return true if an edge lies within STEPPER_STAGGER_GUARD of the moment
+ */
+extern bool stepperEdgeNear(uint16_t offset);
+
+/*!
+ * \brief Declares the current position of an axis to be home
+ *
+ * Zeroes the step counter and enables the soft travel limits.
+ *
+ * \param axis Axis that is at its home position
+ *
+ * \return None
+ */
+extern void setStepperHome(uint8_t axis);
+
+/*!
+ * \brief Checks whether the position of an axis is known
+ *
+ * \param axis Axis to check
+ *
+ * \return true after setStepperHome() has been called for the axis
+ */
+extern bool stepperHomed(uint8_t axis);
 
 /*!
  * \brief Changes rotation speed of stepper motor
  *
- * Updates TA3 CCR0
+ * Sets the target time per half-step. The step interrupt ramps the compare
+ *  interval towards it within the acceleration limits in stepperRamp.h,
+ *  doubling it when stepping in full or wave mode. Periods may exceed 16
+ *  bits, down to a fraction of an RPM. Use RPM_TO_PERIOD() or
+ *  MILLIRPM_TO_PERIOD() to convert a constant speed at compile time.
  *
- * \param RPM How fast the stepper motor should rotate
+ * \param axis   Axis to change
+ * \param period Time per half-step in timer ticks
  *
  * \return None
  */
-extern void setRPM(double RPM);
+extern void setStepPeriod(uint8_t axis, uint32_t period);
 
 
 //*****************************************************************************
@@ -0,0 +1,267 @@
+/*! \file */
+/*!
+ * stepperRamp.c
+ *
+ * Description: Acceleration-limited step rate generator for the stepper motor
+ *              drivers. Each call advances the step rate by acceleration * dt,
+ *              where dt is the period of the step that just finished.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "stepperRamp.h"
+
+#define RAMP_START_RATE_Q       RAMP_PULL_IN_LIMIT
+#define RAMP_START_PERIOD       (((uint32_t)RAMP_CLK_RATE << RAMP_FRAC_BITS) / RAMP_START_RATE_Q)
+
+/*!
+ * Converts a step rate to a timer period, clamped to what the timer and ISR
+ *  can handle.
+ *
+ * \param rate   Step rate in half-steps/s (Q8)
+ * \param stride Half-steps taken per period
+ *
+ * \return Step period in timer ticks
+ */
+static uint32_t rateToPeriod(uint32_t rate, uint8_t stride)
+{
+    uint32_t period;
+
+    if (rate == 0)
+    {
+        return RAMP_MAX_PERIOD;
+    }
+    period = ((uint32_t)RAMP_CLK_RATE << RAMP_FRAC_BITS) / rate;
+    if (period > RAMP_MAX_PERIOD / stride)
+    {
+        return RAMP_MAX_PERIOD;
+    }
+    period *= stride;
+    if (period < RAMP_MIN_PERIOD)
+    {
+        period = RAMP_MIN_PERIOD;
+    }
+    return period;
+}
+
+/*!
+ * Moves the current step rate one step closer to \a goal, limited by the
+ *  acceleration (and jerk, if enabled).
+ *
+ * \param ramp Ramp state
+ * \param goal Step rate to approach (steps/s, Q8)
+ *
+ * \return None
+ */
+static void advanceRate(StepperRamp *ramp, uint32_t goal)
+{
+    uint32_t maxAccel = (uint32_t)ramp->maxAccel << RAMP_FRAC_BITS;
+    bool up = goal > ramp->rate;
+    uint32_t diff = up ? goal - ramp->rate : ramp->rate - goal;
+    uint32_t dv, dt;
+
+    // No ramp needed at or below the pull-in rate
+    if (diff == 0 || (goal <= RAMP_START_RATE_Q && ramp->rate <= RAMP_START_RATE_Q))
+    {
+        ramp->rate = goal;
+        ramp->accel = 0;
+        return;
+    }
+
+    // Leaving slow creep for a faster goal: up to the pull-in rate at once,
+    //  the acceleration only starts from there
+    if (up && ramp->rate < RAMP_START_RATE_Q)
+    {
+        ramp->rate = RAMP_START_RATE_Q;
+        ramp->accel = 0;
+        ramp->speedingUp = true;
+        return;
+    }
+
+    // The period of the step that just finished, but never more than one
+    //  pull-in period. A creep period can be up to RAMP_MAX_PERIOD, which
+    //  would both overflow the products below and gain far more rate than
+    //  the motor can follow in one step.
+    dt = RAMP_START_PERIOD * ramp->stride;
+    if (ramp->period < dt)
+    {
+        dt = ramp->period;
+    }
+
+    // Changing between speeding up and slowing down restarts the S-curve
+    if (up != ramp->speedingUp)
+    {
+        ramp->accel = 0;
+        ramp->speedingUp = up;
+    }
+
+    if (ramp->jerk == 0)
+    {
+        ramp->accel = maxAccel;
+    }
+    else
+    {
+        uint32_t dA = ((uint32_t)ramp->jerk * dt) / RAMP_TICKS_PER_SEC_Q;
+        uint32_t a = ramp->accel >> RAMP_FRAC_BITS;
+        // Rate still gained while easing acceleration back down to zero
+        uint32_t easeOut = (a * a) / (2u * ramp->jerk);
+
+        if (easeOut < (diff >> RAMP_FRAC_BITS))
+        {
+            ramp->accel = (ramp->accel + dA < maxAccel) ? ramp->accel + dA : maxAccel;
+        }
+        else if (ramp->accel > dA + (1u << RAMP_FRAC_BITS))
+        {
+            ramp->accel -= dA;
+        }
+        else
+        {
+            ramp->accel = 1u << RAMP_FRAC_BITS;
+        }
+    }
+
+    dv = ((ramp->accel >> RAMP_FRAC_BITS) * dt) / RAMP_TICKS_PER_SEC_Q;
+    if (dv == 0)
+    {
+        dv = 1;
+    }
+
+    if (dv >= diff)
+    {
+        ramp->rate = goal;
+        ramp->accel = 0;
+    }
+    else if (up)
+    {
+        ramp->rate += dv;
+    }
+    else
+    {
+        ramp->rate -= dv;
+    }
+}
+
+void initRamp(StepperRamp *ramp, uint16_t maxAccel, uint16_t jerk, int8_t direction)
+{
+    ramp->rate = 0;
+    ramp->targetRate = 0;
+    ramp->limitRate = RAMP_NO_LIMIT;
+    ramp->accel = 0;
+    ramp->maxAccel = maxAccel;
+    ramp->jerk = jerk;
+    ramp->period = RAMP_MAX_PERIOD;
+    ramp->stride = 1;
+    ramp->direction = direction;
+    ramp->requestedDirection = direction;
+    ramp->speedingUp = true;
+    ramp->running = false;
+}
+
+void setRampTarget(StepperRamp *ramp, uint32_t period)
+{
+    if (period == 0)
+    {
+        ramp->targetRate = 0;
+    }
+    else if (period >= ((uint32_t)RAMP_CLK_RATE << RAMP_FRAC_BITS))
+    {
+        // Slowest rate that can be represented, rather than a stop
+        ramp->targetRate = 1;
+    }
+    else
+    {
+        ramp->targetRate = ((uint32_t)RAMP_CLK_RATE << RAMP_FRAC_BITS) / period;
+    }
+}
+
+void setRampDirection(StepperRamp *ramp, int8_t direction)
+{
+    ramp->requestedDirection = direction;
+    // From standstill the direction can change immediately
+    if (!ramp->running)
+    {
+        ramp->direction = direction;
+    }
+}
+
+void haltRamp(StepperRamp *ramp)
+{
+    ramp->running = false;
+    ramp->rate = 0;
+    ramp->accel = 0;
+}
+
+void setRampLimit(StepperRamp *ramp, uint32_t rate)
+{
+    ramp->limitRate = rate;
+}
+
+uint32_t rampStopSteps(const StepperRamp *ramp)
+{
+    uint32_t rate = ramp->rate >> RAMP_FRAC_BITS;
+    uint32_t steps;
+
+    if (rate <= RAMP_START_RATE || ramp->maxAccel == 0)
+    {
+        return 0;
+    }
+    // v^2 = u^2 + 2as, rounded up by one step
+    steps = (rate * rate - (uint32_t)RAMP_START_RATE * RAMP_START_RATE) / (2u * ramp->maxAccel) + 1;
+    // Easing the deceleration in and out adds about rate * (accel / jerk) / 2
+    if (ramp->jerk != 0)
+    {
+        steps += (rate * ramp->maxAccel / ramp->jerk) >> 1;
+    }
+    return steps;
+}
+
+uint32_t startRamp(StepperRamp *ramp)
+{
+    if (!ramp->running)
+    {
+        // The pull-in rate also when there is no target yet, so a target
+        //  set just after the start still gets a first step at that rate
+        ramp->rate = (ramp->targetRate != 0 && ramp->targetRate < RAMP_START_RATE_Q)
+                        ? ramp->targetRate : RAMP_START_RATE_Q;
+        ramp->accel = 0;
+        ramp->direction = ramp->requestedDirection;
+        ramp->period = rateToPeriod(ramp->rate, ramp->stride);
+        ramp->running = true;
+    }
+    return ramp->period;
+}
+
+uint32_t rampNextPeriod(StepperRamp *ramp)
+{
+    uint32_t goal = (ramp->targetRate < ramp->limitRate) ? ramp->targetRate : ramp->limitRate;
+
+    // Slow down to the pull-in rate before reversing
+    if (ramp->requestedDirection != ramp->direction)
+    {
+        if (ramp->rate > RAMP_START_RATE_Q)
+        {
+            goal = 0;
+        }
+        else
+        {
+            ramp->direction = ramp->requestedDirection;
+            ramp->accel = 0;
+        }
+    }
+
+    // Stopping is only safe once at or below the pull-in rate
+    if (goal == 0)
+    {
+        if (ramp->rate <= RAMP_START_RATE_Q)
+        {
+            haltRamp(ramp);
+            return 0;
+        }
+        goal = RAMP_START_RATE_Q;
+    }
+
+    advanceRate(ramp, goal);
+    ramp->period = rateToPeriod(ramp->rate, ramp->stride);
+    return ramp->period;
+}
@@ -0,0 +1,170 @@
+/*! \file */
+/*!
+ * stepperRamp.h
+ *
+ * Description: Acceleration-limited step rate generator for the stepper motor
+ *              drivers. Called once per step from the step interrupt to
+ *              produce the next step period using integer math only.
+ *
+ *              Step rates are kept in half-steps per second with
+ *              RAMP_FRAC_BITS fractional bits. Each timer period may cover
+ *              one or two half-steps (see stride) depending on step mode.
+ *              With jerk set to 0 the profile is trapezoidal, otherwise
+ *              acceleration itself ramps at the given jerk and the profile
+ *              becomes an S-curve. At or below the pull-in rate the motor
+ *              follows any speed change at once, which allows periods far
+ *              longer than one timer rollover for slow creep.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef STEPPERRAMP_H_
+#define STEPPERRAMP_H_
+
+//*****************************************************************************
+//
+// If building with a C++ compiler, make all of the definitions in this header
+// have a C binding.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RAMP_CLK_RATE                   4000000     // Timer tick rate (Hz)
+#define RAMP_FRAC_BITS                  8           // Fractional bits of step rates
+#define RAMP_TICKS_PER_SEC_Q            (RAMP_CLK_RATE >> RAMP_FRAC_BITS)
+
+#define RAMP_START_RATE                 300         // Pull-in rate from standstill (steps/s)
+#define RAMP_MAX_ACCEL                  2500        // Default acceleration (steps/s^2), max 65535
+#define RAMP_JERK                       0           // Default jerk (steps/s^3), 0 = trapezoidal
+#define RAMP_MIN_PERIOD                 200         // Shortest period the ISR can service (ticks)
+#define RAMP_MAX_PERIOD                 0x7FFFFFFF  // Longest period, about 9 minutes (ticks)
+#define RAMP_NO_LIMIT                   0xFFFFFFFF
+#define RAMP_PULL_IN_LIMIT              ((uint32_t)RAMP_START_RATE << RAMP_FRAC_BITS)
+
+typedef struct
+{
+    uint32_t rate;              // Current step rate (steps/s, Q8)
+    uint32_t targetRate;        // Requested step rate (steps/s, Q8), 0 = stop
+    uint32_t limitRate;         // Cap on the step rate set by the driver (steps/s, Q8)
+    uint32_t accel;             // Current acceleration (steps/s^2, Q8)
+    uint16_t maxAccel;          // Acceleration limit (steps/s^2)
+    uint16_t jerk;              // Jerk limit (steps/s^3), 0 = trapezoidal
+    uint32_t period;            // Period of the step being timed (ticks)
+    uint8_t stride;             // Half-steps taken per timer period (1 or 2)
+    int8_t direction;           // Direction currently being stepped
+    int8_t requestedDirection;  // Direction to switch to once slowed down
+    bool speedingUp;            // Sign of the last rate change (for S-curve)
+    bool running;               // Whether the axis is stepping
+} StepperRamp;
+
+/*!
+ * \brief Initializes a ramp generator at standstill
+ *
+ * \param ramp      Ramp state to initialize
+ * \param maxAccel  Acceleration limit in steps/s^2 (at most 65535)
+ * \param jerk      Jerk limit in steps/s^3, 0 for a trapezoidal profile
+ * \param direction Initial direction of travel
+ *
+ * \return None
+ */
+extern void initRamp(StepperRamp *ramp, uint16_t maxAccel, uint16_t jerk, int8_t direction);
+
+/*!
+ * \brief Sets the step period the ramp should accelerate or decelerate to
+ *
+ * \param ramp      Ramp state
+ * \param period    Target time per half-step in timer ticks, 0 to ramp down
+ *                  and stop
+ *
+ * \return None
+ */
+extern void setRampTarget(StepperRamp *ramp, uint32_t period);
+
+/*!
+ * \brief Requests a direction of travel
+ *
+ * If the axis is moving the other way, the ramp first slows down to the
+ *  pull-in rate and only then reverses.
+ *
+ * \param ramp      Ramp state
+ * \param direction Requested direction
+ *
+ * \return None
+ */
+extern void setRampDirection(StepperRamp *ramp, int8_t direction);
+
+/*!
+ * \brief Starts the ramp from standstill
+ *
+ * The first step is at the target rate if that is below the pull-in rate,
+ *  otherwise at the pull-in rate, also if no target has been set yet.
+ *  Does nothing if the ramp is already running.
+ *
+ * \param ramp      Ramp state
+ *
+ * \return Period of the first step in timer ticks
+ */
+extern uint32_t startRamp(StepperRamp *ramp);
+
+/*!
+ * \brief Stops the ramp immediately
+ *
+ * Only safe at or below the pull-in rate, e.g. after braking for a limit.
+ *
+ * \param ramp      Ramp state
+ *
+ * \return None
+ */
+extern void haltRamp(StepperRamp *ramp);
+
+/*!
+ * \brief Limits the step rate regardless of the target
+ *
+ * Used by the driver to slow down when approaching a travel limit or a
+ *  target position, without losing the requested target speed.
+ *
+ * \param ramp      Ramp state
+ * \param rate      Maximum rate in steps/s (Q8), RAMP_NO_LIMIT to remove
+ *
+ * \return None
+ */
+extern void setRampLimit(StepperRamp *ramp, uint32_t rate);
+
+/*!
+ * \brief Computes how many steps it takes to slow down to the pull-in rate
+ *
+ * \param ramp      Ramp state
+ *
+ * \return Braking distance in steps at the current rate
+ */
+extern uint32_t rampStopSteps(const StepperRamp *ramp);
+
+/*!
+ * \brief Computes the period of the next step
+ *
+ * Must be called exactly once per step, from the step interrupt.
+ *
+ * \param ramp      Ramp state
+ *
+ * \return Period of the next step in timer ticks, 0 once the axis has
+ *          decelerated to a stop and the timer should be halted
+ */
+extern uint32_t rampNextPeriod(StepperRamp *ramp);
+
+//*****************************************************************************
+//
+// Mark the end of the C bindings section for C++ compilers.
+//
+//*****************************************************************************
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STEPPERRAMP_H_ */
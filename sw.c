@@ -13,6 +13,10 @@
 
 extern int curState;
 
+static ButtonSnapshot button;
+static SeqLock buttonSeq;
+static bool pressed;
+
 /**
  * @brief Initializes S2 switch
  *
@@ -20,9 +24,10 @@ extern int curState;
  */
 void initializeSwitches(void)
 {
-    pressed = 0;
-    resetNeeded = 0;
-    lastPressedTime = RESET_LAST_PRESSED_TIME;
+    pressed = false;
+    button.resetNeeded = false;
+    button.lastPressed = 0;
+    button.lastPressedTime = RESET_LAST_PRESSED_TIME;
 
     // Set P2.4 to be primary module function input (capture CCIxA for TA0) and pull-up
     SwitchPort->SEL0 |= (JoystickSwitch);
@@ -47,43 +52,54 @@ void initializeSwitches(void)
 /*!
  * \brief TA0 CCRN interrupt service routine
  *
- * Handles press/release of pushbutton.
+ * Handles press/release of pushbutton, and starts each ADC frame on CCR2.
  *
  * \return None
  */
 /* Timer_A0 and CCRx (except CCR0) interrupt service routine */
 void TA0_N_IRQHandler(void)
 {
+    /* Check if interrupt triggered by CCR2, the ADC frame timer */
+    if (TIMER_A0->CCTL[2] & TIMER_A_CCTLN_CCIFG)
+    {
+        TIMER_A0->CCTL[2] &= ~(TIMER_A_CCTLN_CCIFG);
+        startAdcFrame();
+    }
+
     /* Check if interrupt triggered by CCR1 */
     if (TIMER_A0->CCTL[1] & TIMER_A_CCTLN_CCIFG)
     {
+        seqWriteBegin(&buttonSeq);
+
         // Update press/release status
         if (pressed)
         {
-            pressed = 0;
+            pressed = false;
         }
 
         else
         {
-            // First toggle Red LED for debugging purposes & feedback
-            RGB_PORT->OUT ^= (RGB_RED_PIN);
+            // First toggle Red LED for debugging purposes & feedback,
+            //  through its bit-band alias since the X stepper shares P2
+            GPIO_BIT(RGB_PORT->OUT, RGB_RED_BIT) ^= 1;
 
             // If pressed during gameplay, toggle claw and save lastPressed times
             if (curState == JOYSTICK_MOVE_STATE)
             {
                 toggleServo();
-                lastPressed = TIMER_A0->CCR[1];
-                lastPressedTime = curTime;
+                button.lastPressed = TIMER_A0->CCR[1];
+                button.lastPressedTime = timeLeft();
             }
 
             // If pressed during end of game state, a reset is needed
             if (curState == GAME_WON_STATE || curState == GAME_OVER_STATE)
             {
-                resetNeeded = 1;
+                button.resetNeeded = true;
             }
 
-            pressed = 1;
+            pressed = true;
         }
+        seqWriteEnd(&buttonSeq);
 
         int delayLeft = DELAY_TIME; // Delay time for debouncing switches
 
@@ -99,3 +115,28 @@ void TA0_N_IRQHandler(void)
         TIMER_A0->CCTL[1] &= ~(TIMER_A_CCTLN_CCIFG);
     }
 }
+
+void readButton(ButtonSnapshot *snapshot)
+{
+    uint32_t start;
+
+    do
+    {
+        start = seqReadBegin(&buttonSeq);
+        *snapshot = button;
+    } while (seqReadRetry(&buttonSeq, start));
+}
+
+void clearResetRequest(void)
+{
+    seqWriteBegin(&buttonSeq);
+    button.resetNeeded = false;
+    seqWriteEnd(&buttonSeq);
+}
+
+void forgetLastPress(void)
+{
+    seqWriteBegin(&buttonSeq);
+    button.lastPressedTime = RESET_LAST_PRESSED_TIME;
+    seqWriteEnd(&buttonSeq);
+}
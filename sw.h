@@ -22,6 +22,8 @@ extern "C"
 #endif
 
 #include <msp.h>
+#include <stdbool.h>
+#include "seqlock.h"
 
 #define SwitchPort          P2               // Port 2
 #define JoystickSwitch      0b00010000       // P2.4 is the joystick button
@@ -29,11 +31,12 @@ extern "C"
 #define DELAY_TIME              1500
 #define RESET_LAST_PRESSED_TIME 100
 
-int pressed;
-int resetNeeded;
-
-int lastPressed;
-int lastPressedTime;
+typedef struct
+{
+    bool resetNeeded;           // Pressed after the round ended
+    uint16_t lastPressed;       // Timer_A0 count of the last press during play
+    int lastPressedTime;        // Seconds left at that press
+} ButtonSnapshot;
 
 /*!
  * \brief Initializes P2.4 for primary module function.
@@ -45,6 +48,35 @@ int lastPressedTime;
  */
 extern void initializeSwitches(void);
 
+/*!
+ * \brief Copies the button state as of one press
+ *
+ * Main loop only, see seqlock.h.
+ *
+ * \param button Receives the button state
+ *
+ * \return None
+ */
+extern void readButton(ButtonSnapshot *button);
+
+/*!
+ * \brief Marks the reset request as handled
+ *
+ * Main loop only.
+ *
+ * \return None
+ */
+extern void clearResetRequest(void);
+
+/*!
+ * \brief Forgets the last press, so it earns no bonus
+ *
+ * Main loop only.
+ *
+ * \return None
+ */
+extern void forgetLastPress(void);
+
 //*****************************************************************************
 //
 // Mark the end of the C bindings section for C++ compilers.
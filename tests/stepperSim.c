@@ -0,0 +1,105 @@
+/*! \file */
+/*!
+ * stepperSim.c
+ *
+ * Description: Simulated Timer_A3 for the stepper driver host tests.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "stepperSim.h"
+
+extern void TA3_0_IRQHandler(void);
+extern void TA3_N_IRQHandler(void);
+
+uint64_t simTime;
+
+static void (*simHook)(uint8_t ccr);
+
+/*!
+ * Finds the armed compare that matches first
+ *
+ * \param delay Ticks until it matches
+ *
+ * \return Compare register, SIM_NO_COMPARE if none is armed
+ */
+static uint8_t nextCompare(uint16_t *delay)
+{
+    uint16_t now = STEPPER_TIMER->R;
+    uint16_t ticks;
+    uint8_t ccr, next = SIM_NO_COMPARE;
+
+    for (ccr = 0; ccr <= MAX_STEPPERS; ccr++)
+    {
+        if (STEPPER_TIMER->CCTL[ccr] & TIMER_A_CCTLN_CCIE)
+        {
+            ticks = STEPPER_TIMER->CCR[ccr] - now;
+            if (next == SIM_NO_COMPARE || ticks < *delay)
+            {
+                *delay = ticks;
+                next = ccr;
+            }
+        }
+    }
+    return next;
+}
+
+void simInitSteppers(void)
+{
+    uint8_t axis;
+
+    initStepperMotors();
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        setStepperDma(axis, false);
+        setStepperHome(axis);
+    }
+    stubBitbandSync();
+}
+
+uint8_t simTick(void)
+{
+    uint16_t delay;
+    uint8_t next = nextCompare(&delay);
+
+    if (next == SIM_NO_COMPARE)
+    {
+        return SIM_NO_COMPARE;
+    }
+
+    simTime += delay;
+    STEPPER_TIMER->R += delay;
+    if (next == 0)
+    {
+        TA3_0_IRQHandler();
+    }
+    else
+    {
+        stubPostTimerA3Vector(next * 2);
+        TA3_N_IRQHandler();
+    }
+    stubBitbandSync();
+    if (simHook != 0)
+    {
+        simHook(next);
+    }
+    return next;
+}
+
+void simRunUntil(uint64_t time)
+{
+    uint16_t delay;
+
+    while (nextCompare(&delay) != SIM_NO_COMPARE && simTime + delay < time)
+    {
+        simTick();
+    }
+    STEPPER_TIMER->R += (uint16_t)(time - simTime);
+    simTime = time;
+}
+
+void simSetHook(void (*hook)(uint8_t ccr))
+{
+    simHook = hook;
+}
@@ -0,0 +1,58 @@
+/*! \file */
+/*!
+ * stepperSim.h
+ *
+ * Description: Runs the stepper driver on a simulated Timer_A3 for the host
+ *              tests. The free running counter jumps straight to the next
+ *              armed compare, whose interrupt is then taken.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef STEPPERSIM_H_
+#define STEPPERSIM_H_
+
+#include "stepperMotor.h"
+
+#define SIM_NO_COMPARE  0xFF            // No STEPPER_TIMER compare armed
+
+// Ticks since the simulation started
+extern uint64_t simTime;
+
+/*!
+ * \brief Sets up both axes at home, with DMA stepping off
+ *
+ * The simulation has no uDMA, so cruising axes must stay with the step
+ *  interrupt.
+ *
+ * \return None
+ */
+extern void simInitSteppers(void);
+
+/*!
+ * \brief Advances to the next armed STEPPER_TIMER compare and services it
+ *
+ * \return Compare register that was serviced, SIM_NO_COMPARE if none was armed
+ */
+extern uint8_t simTick(void);
+
+/*!
+ * \brief Services the compares due before a moment, then advances to it
+ *
+ * \param time Moment to run to, in ticks since the simulation started
+ *
+ * \return None
+ */
+extern void simRunUntil(uint64_t time);
+
+/*!
+ * \brief Calls a function after every compare serviced by simTick()
+ *
+ * \param hook Function to call, 0 for none
+ *
+ * \return None
+ */
+extern void simSetHook(void (*hook)(uint8_t ccr));
+
+#endif /* STEPPERSIM_H_ */
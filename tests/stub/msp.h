@@ -0,0 +1,366 @@
+/*! \file */
+/*!
+ * msp.h
+ *
+ * Description: Host stand-in for the TI MSP432P4111 device header, so the
+ *              drivers build and run on a PC for the tests. Peripherals are
+ *              plain structures in RAM with only the registers and bit
+ *              fields the drivers use. Nothing happens on its own: a test
+ *              moves the timers and raises the interrupts it needs.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef MSP_STUB_H
+#define MSP_STUB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#define __IO volatile
+#define __I volatile
+#define __O volatile
+typedef enum { PSS_IRQn=0, CS_IRQn, PCM_IRQn, WDT_A_IRQn, FPU_IRQn, FLCTL_A_IRQn, COMP_E0_IRQn, COMP_E1_IRQn,
+ TA0_0_IRQn, TA0_N_IRQn, TA1_0_IRQn, TA1_N_IRQn, TA2_0_IRQn, TA2_N_IRQn, TA3_0_IRQn, TA3_N_IRQn,
+ EUSCIA0_IRQn, EUSCIA1_IRQn, EUSCIA2_IRQn, EUSCIA3_IRQn, EUSCIB0_IRQn, EUSCIB1_IRQn, EUSCIB2_IRQn, EUSCIB3_IRQn,
+ ADC14_IRQn, T32_INT1_IRQn, T32_INT2_IRQn, T32_INTC_IRQn, AES256_IRQn, RTC_C_IRQn, DMA_ERR_IRQn, DMA_INT3_IRQn,
+ DMA_INT2_IRQn, DMA_INT1_IRQn, DMA_INT0_IRQn, PORT1_IRQn, PORT2_IRQn } IRQn_Type;
+typedef struct
+{
+    uint8_t RESERVED0;
+    __I uint8_t IN;
+    uint8_t R1;
+    __IO uint8_t OUT;
+    uint8_t R2;
+    __IO uint8_t DIR;
+    uint8_t R3;
+    __IO uint8_t REN;
+    uint8_t R4;
+    __IO uint8_t DS;
+    uint8_t R5;
+    __IO uint8_t SEL0;
+    uint8_t R6;
+    __IO uint8_t SEL1;
+} DIO_PORT_Even_Interruptable_Type;
+typedef struct
+{
+    __I uint8_t IN;
+    uint8_t R0;
+    __IO uint8_t OUT;
+    uint8_t R1;
+    __IO uint8_t DIR;
+    uint8_t R2;
+    __IO uint8_t REN;
+    uint8_t R3;
+    __IO uint8_t DS;
+    uint8_t R4;
+    __IO uint8_t SEL0;
+    uint8_t R5;
+    __IO uint8_t SEL1;
+} DIO_PORT_Odd_Interruptable_Type;
+extern DIO_PORT_Odd_Interruptable_Type stubP1, stubP3, stubP5;
+extern DIO_PORT_Even_Interruptable_Type stubP2, stubP4, stubP6;
+#define P1 (&stubP1)
+#define P2 (&stubP2)
+#define P3 (&stubP3)
+#define P4 (&stubP4)
+#define P5 (&stubP5)
+#define P6 (&stubP6)
+extern DIO_PORT_Even_Interruptable_Type stubP8;
+extern DIO_PORT_Odd_Interruptable_Type stubP9;
+#define P8 (&stubP8)
+#define P9 (&stubP9)
+typedef struct
+{
+    __IO uint16_t CTL;
+    __IO uint16_t CCTL[7];
+    __IO uint16_t R;
+    __IO uint16_t CCR[7];
+    __IO uint16_t EX0;
+    uint16_t RES[6];
+    __I uint16_t IV;
+} Timer_A_Type;
+extern Timer_A_Type stubTA[4];
+#define TIMER_A0 (&stubTA[0])
+#define TIMER_A1 (&stubTA[1])
+#define TIMER_A2 (&stubTA[2])
+// TA3 is read through a function so its IV register can clear on read: a
+//  vector posted with stubPostTimerA3Vector() is in IV for the next access
+//  only. Post one vector at a time.
+#define TIMER_A3 (stubTimerA3())
+Timer_A_Type *stubTimerA3(void);
+void stubPostTimerA3Vector(uint16_t vector);
+#define TIMER_A_CCTLN_CCIFG (0x0001)
+#define TIMER_A_CCTLN_CCIE (0x0010)
+#define TIMER_A_CCTLN_OUT (0x0004)
+#define TIMER_A_CCTLN_OUTMOD_0 (0x0000)
+#define TIMER_A_CCTLN_OUTMOD_3 (0x0060)
+#define TIMER_A_CCTLN_OUTMOD_4 (0x0080)
+#define TIMER_A_CCTLN_OUTMOD_7 (0x00E0)
+#define TIMER_A_CCTLN_OUTMOD_MASK (0x00E0)
+#define TIMER_A_CTL_IFG (0x0001)
+#define TIMER_A_CTL_IE (0x0002)
+#define TIMER_A_CTL_CLR (0x0004)
+#define TIMER_A_CTL_MC_MASK (0x0030)
+#define TIMER_A_CTL_MC__STOP (0x0000)
+#define TIMER_A_CTL_MC__UP (0x0010)
+#define TIMER_A_CTL_MC__CONTINUOUS (0x0020)
+#define TIMER_A_CTL_ID_MASK (0x00C0)
+#define TIMER_A_CTL_ID_OFS (6)
+#define TIMER_A_CTL_ID__1 (0x0000)
+#define TIMER_A_CTL_SSEL__ACLK (0x0100)
+#define TIMER_A_CTL_SSEL__SMCLK (0x0200)
+#define TIMER_A_EX0_IDEX_MASK (0x0007)
+#define TIMER_A_EX0_IDEX__3 (0x0002)
+typedef struct
+{
+    __IO uint32_t LOAD;
+    __I uint32_t VALUE;
+    __IO uint32_t CONTROL;
+    __O uint32_t INTCLR;
+    __I uint32_t RIS;
+    __I uint32_t MIS;
+    __IO uint32_t BGLOAD;
+} Timer32_Type;
+extern Timer32_Type stubT32[2];
+#define TIMER32_1 (&stubT32[0])
+#define TIMER32_2 (&stubT32[1])
+#define TIMER32_CONTROL_ENABLE (0x80)
+#define TIMER32_CONTROL_MODE (0x40)
+#define TIMER32_CONTROL_IE (0x20)
+#define TIMER32_CONTROL_SIZE (0x02)
+#define TIMER32_CONTROL_ONESHOT (0x01)
+#define TIMER32_CONTROL_PRESCALE_0 (0x00)
+typedef struct
+{
+    __IO uint32_t CTL0;
+    __IO uint32_t CTL1;
+    __IO uint32_t LO0;
+    __IO uint32_t HI0;
+    __IO uint32_t LO1;
+    __IO uint32_t HI1;
+    __IO uint32_t MCTL[32];
+    __IO uint32_t MEM[32];
+    uint32_t R[9];
+    __IO uint32_t IER0;
+    __IO uint32_t IER1;
+    __I uint32_t IFGR0;
+    __I uint32_t IFGR1;
+    __O uint32_t CLRIFGR0;
+    __IO uint32_t CLRIFGR1;
+    __I uint32_t IV;
+} ADC14_Type;
+extern ADC14_Type stubADC;
+#define ADC14 (&stubADC)
+#define ADC14_CTL0_SC (0x00000001)
+#define ADC14_CTL0_ENC (0x00000002)
+#define ADC14_CTL0_ON (0x00000010)
+#define ADC14_CTL0_MSC (0x00000080)
+#define ADC14_CTL0_BUSY (0x00010000)
+#define ADC14_CTL0_SHT0__4 (0x00000000)
+#define ADC14_CTL0_SHT0__16 (0x00000200)
+#define ADC14_CTL0_SHT0__32 (0x00000300)
+#define ADC14_CTL0_SHT0__64 (0x00000400)
+#define ADC14_CTL0_SHT0__96 (0x00000500)
+#define ADC14_CTL0_SHT0__128 (0x00000600)
+#define ADC14_CTL0_SHT0__192 (0x00000700)
+#define ADC14_CTL0_SHT1__16 (0x00002000)
+#define ADC14_CTL0_SHT1__64 (0x00004000)
+#define ADC14_CTL0_CONSEQ_1 (0x00020000)
+#define ADC14_CTL0_CONSEQ_3 (0x00060000)
+#define ADC14_CTL0_CONSEQ_MASK (0x00060000)
+#define ADC14_CTL0_SSEL__MODCLK (0x00000000)
+#define ADC14_CTL0_DIV__1 (0x00000000)
+#define ADC14_CTL0_SHP (0x04000000)
+#define ADC14_CTL0_SHS_0 (0x00000000)
+#define ADC14_CTL0_SHS_2 (0x10000000)
+#define ADC14_CTL0_SHS_3 (0x18000000)
+#define ADC14_CTL0_SHS_MASK (0x38000000)
+#define ADC14_CTL0_PDIV__1 (0x00000000)
+#define ADC14_CTL1_RES__10BIT (0x00000010)
+#define ADC14_CTL1_RES__14BIT (0x00000030)
+#define ADC14_CTL1_CSTARTADD_OFS (16)
+#define ADC14_CTL1_PWRMD_2 (0x00000002)
+#define ADC14_MCTLN_INCH_MASK (0x0000001F)
+#define ADC14_MCTLN_EOS (0x00000080)
+#define ADC14_MCTLN_WINC (0x00004000)
+#define ADC14_MCTLN_WINCTH (0x00008000)
+#define ADC14_IER1_INIE (0x00000002)
+#define ADC14_IER1_LOIE (0x00000004)
+#define ADC14_IER1_HIIE (0x00000008)
+#define ADC14_IFGR1_INIFG (0x00000002)
+#define ADC14_IFGR1_LOIFG (0x00000004)
+#define ADC14_IFGR1_HIIFG (0x00000008)
+#define ADC14_CLRIFGR1_CLRINIFG (0x00000002)
+#define ADC14_CLRIFGR1_CLRLOIFG (0x00000004)
+#define ADC14_CLRIFGR1_CLRHIIFG (0x00000008)
+#define ADC14_IFGR0_IFG1 (0x00000002)
+#define ADC14_IFGR0_IFG2 (0x00000004)
+#define ADC14_IFGR0_IFG3 (0x00000008)
+#define ADC14_IFGR0_IFG4 (0x00000010)
+typedef struct
+{
+    __IO uint32_t ISER[8];
+    uint32_t R0[24];
+    __IO uint32_t ICER[8];
+    uint32_t R1[24];
+    __IO uint32_t ISPR[8];
+    uint32_t R2[24];
+    __IO uint32_t ICPR[8];
+    uint32_t R3[24];
+    __IO uint32_t IABR[8];
+    uint32_t R4[56];
+    __IO uint8_t IP[240];
+} NVIC_Type;
+extern NVIC_Type stubNVIC;
+#define NVIC (&stubNVIC)
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __I uint32_t CALIB;
+} SysTick_Type;
+extern SysTick_Type stubSysTick;
+#define SysTick (&stubSysTick)
+#define SysTick_CTRL_ENABLE_Msk (1UL)
+#define SysTick_CTRL_TICKINT_Msk (2UL)
+#define SysTick_CTRL_CLKSOURCE_Msk (4UL)
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+extern DWT_Type stubDWT;
+#define DWT (&stubDWT)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+typedef struct
+{
+    __IO uint32_t DHCSR;
+    __IO uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+extern CoreDebug_Type stubCoreDebug;
+#define CoreDebug (&stubCoreDebug)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+typedef struct
+{
+    __I uint32_t DEVICE_CFG;
+    __IO uint32_t SW_CHTRIG;
+    uint32_t R0[2];
+    __IO uint32_t CH_SRCCFG[32];
+    uint32_t R1[28];
+    __IO uint32_t INT1_SRCCFG;
+    __IO uint32_t INT2_SRCCFG;
+    __IO uint32_t INT3_SRCCFG;
+    uint32_t R2;
+    __I uint32_t INT0_SRCFLG;
+    __O uint32_t INT0_CLRFLG;
+} DMA_Channel_Type;
+typedef struct
+{
+    __I uint32_t STAT;
+    __O uint32_t CFG;
+    __IO uint32_t CTLBASE;
+    __I uint32_t ALTBASE;
+    __I uint32_t WAITSTAT;
+    __O uint32_t SWREQ;
+    __IO uint32_t USEBURSTSET;
+    __O uint32_t USEBURSTCLR;
+    __IO uint32_t REQMASKSET;
+    __O uint32_t REQMASKCLR;
+    __IO uint32_t ENASET;
+    __O uint32_t ENACLR;
+    __IO uint32_t ALTSET;
+    __O uint32_t ALTCLR;
+    __IO uint32_t PRIOSET;
+    __O uint32_t PRIOCLR;
+    uint32_t R[3];
+    __IO uint32_t ERRCLR;
+} DMA_Control_Type;
+extern DMA_Channel_Type stubDMAch; extern DMA_Control_Type stubDMActl;
+#define DMA_Channel (&stubDMAch)
+#define DMA_Control (&stubDMActl)
+#define DMA_STAT_MASTEN (0x00000001)
+#define DMA_CFG_MASTEN (0x00000001)
+#define DMA_INT1_SRCCFG_EN (0x00000020)
+typedef struct
+{
+    __IO uint32_t POWER_STAT;
+    uint32_t R0[3];
+    __IO uint32_t BANK0_RDCTL;
+    __IO uint32_t BANK1_RDCTL;
+    uint32_t R1[2];
+    __IO uint32_t RDBRST_CTLSTAT;
+    uint32_t R2[7];
+    __IO uint32_t PRG_CTLSTAT;
+    __IO uint32_t PRGBRST_CTLSTAT;
+    uint32_t R3[14];
+    __IO uint32_t ERASE_CTLSTAT;
+    __IO uint32_t ERASE_SECTADDR;
+    uint32_t R4[2];
+    __IO uint32_t BANK0_INFO_WEPROT;
+    __IO uint32_t BANK0_MAIN_WEPROT0;
+    uint32_t R5[6];
+    __IO uint32_t BANK1_INFO_WEPROT;
+    uint32_t R6[20];
+    __IO uint32_t CLRIFG;
+} FLCTL_A_Type;
+extern FLCTL_A_Type stubFLCTL;
+#define FLCTL_A (&stubFLCTL)
+#define FLCTL_A_PRG_CTLSTAT_ENABLE (0x00000001)
+#define FLCTL_A_PRG_CTLSTAT_MODE (0x00000002)
+#define FLCTL_A_PRG_CTLSTAT_STATUS_MASK (0x00030000)
+#define FLCTL_A_ERASE_CTLSTAT_START (0x00000001)
+#define FLCTL_A_ERASE_CTLSTAT_MODE (0x00000002)
+#define FLCTL_A_ERASE_CTLSTAT_TYPE_1 (0x00000004)
+#define FLCTL_A_ERASE_CTLSTAT_STATUS_MASK (0x00030000)
+#define FLCTL_A_ERASE_CTLSTAT_CLR_STAT (0x00080000)
+#define FLCTL_A_ERASE_CTLSTAT_STATUS_3 (0x00030000)
+#define FLCTL_A_BANK0_INFO_WEPROT_PROT0 (0x00000001)
+#define FLCTL_A_BANK0_INFO_WEPROT_PROT1 (0x00000002)
+#define FLCTL_A_BANK1_INFO_WEPROT_PROT0 (0x00000001)
+typedef struct
+{
+    __IO uint16_t CTL;
+} WDT_A_Type;
+extern WDT_A_Type stubWDT;
+#define WDT_A (&stubWDT)
+#define WDT_A_CTL_PW (0x5A00)
+#define WDT_A_CTL_HOLD (0x0080)
+typedef struct
+{
+    __IO uint32_t KEY;
+    __IO uint32_t CTL0;
+    __IO uint32_t CTL1;
+} CS_Type;
+extern CS_Type stubCS;
+#define CS (&stubCS)
+#define CS_KEY_VAL (0x695A)
+#define CS_CTL0_DCORSEL_3 (0x00030000)
+#define CS_CTL1_SELA_2 (0x00000200)
+#define CS_CTL1_SELS_3 (0x30000000)
+#define CS_CTL1_SELM_3 (0x00000003)
+#define PERIPH_BASE (0x40000000UL)
+#define BITBAND_PERI_BASE (0x42000000UL)
+#define BIT0 (0x01)
+#define BIT1 (0x02)
+#define BIT2 (0x04)
+#define BIT3 (0x08)
+#define BIT4 (0x10)
+#define BIT5 (0x20)
+#define BIT6 (0x40)
+#define BIT7 (0x80)
+static inline void __enable_irq(void) {}
+static inline void __disable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t m) { (void)m; }
+static inline void __NOP(void) {}
+static inline void __DMB(void) {}
+// Bit-band aliases are shadow words, stubBitbandSync() folds them back
+volatile uint32_t *stubBitband(volatile const void *reg, uint8_t bit);
+void stubBitbandSync(void);
+#define BITBAND_PERI(x, b) (*stubBitband(&(x), (b)))
+#endif
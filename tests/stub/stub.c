@@ -0,0 +1,97 @@
+/*! \file */
+/*!
+ * stub.c
+ *
+ * Description: Peripheral registers of the host stand-in for msp.h.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "msp.h"
+
+DIO_PORT_Odd_Interruptable_Type stubP1, stubP3, stubP5, stubP9;
+DIO_PORT_Even_Interruptable_Type stubP2, stubP4, stubP6, stubP8;
+Timer_A_Type stubTA[4];
+Timer32_Type stubT32[2];
+ADC14_Type stubADC;
+NVIC_Type stubNVIC;
+SysTick_Type stubSysTick;
+DWT_Type stubDWT;
+CoreDebug_Type stubCoreDebug;
+DMA_Channel_Type stubDMAch;
+DMA_Control_Type stubDMActl;
+FLCTL_A_Type stubFLCTL;
+WDT_A_Type stubWDT;
+CS_Type stubCS;
+
+// Vector to show in TA3IV on the next access
+static uint16_t stubTA3Vector;
+
+// Bit-band aliases handed out so far, word is 0xFFFFFFFF until written
+#define STUB_ALIASES    64
+static struct
+{
+    volatile uint8_t *reg;
+    uint8_t bit;
+    uint32_t word;
+} stubAlias[STUB_ALIASES];
+static int stubAliasCount;
+
+Timer_A_Type *stubTimerA3(void)
+{
+    stubTA[3].IV = stubTA3Vector;
+    stubTA3Vector = 0;
+    return &stubTA[3];
+}
+
+void stubPostTimerA3Vector(uint16_t vector)
+{
+    stubTA3Vector = vector;
+}
+
+volatile uint32_t *stubBitband(volatile const void *reg, uint8_t bit)
+{
+    int i;
+
+    for (i = 0; i < stubAliasCount; i++)
+    {
+        if (stubAlias[i].reg == reg && stubAlias[i].bit == bit)
+        {
+            break;
+        }
+    }
+    if (i == stubAliasCount)
+    {
+        stubAlias[i].reg = (volatile uint8_t *)reg;
+        stubAlias[i].bit = bit;
+        stubAliasCount++;
+    }
+
+    // Fold pending writes first, then read the bit back through the alias
+    stubBitbandSync();
+    stubAlias[i].word = (*stubAlias[i].reg >> bit) & 1;
+    return &stubAlias[i].word;
+}
+
+void stubBitbandSync(void)
+{
+    int i;
+
+    for (i = 0; i < stubAliasCount; i++)
+    {
+        if (stubAlias[i].word == 0xFFFFFFFF)
+        {
+            continue;
+        }
+        if (stubAlias[i].word)
+        {
+            *stubAlias[i].reg |= 1 << stubAlias[i].bit;
+        }
+        else
+        {
+            *stubAlias[i].reg &= ~(1 << stubAlias[i].bit);
+        }
+        stubAlias[i].word = 0xFFFFFFFF;
+    }
+}
@@ -0,0 +1,47 @@
+/*! \file */
+/*!
+ * test.h
+ *
+ * Description: Minimal checks for the host tests. Each test is a program
+ *              that runs the driver code against the stand-in msp.h,
+ *              reports every failed check with its location and exits
+ *              non-zero if any failed.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+static int testFailures;
+
+// Reports a failed check, the remaining arguments are a printf() message
+#define CHECK(cond, ...)                                                    \
+    do                                                                      \
+    {                                                                       \
+        if (!(cond))                                                        \
+        {                                                                   \
+            printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+            printf(__VA_ARGS__);                                            \
+            printf("\n");                                                   \
+            testFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+/*!
+ * \brief Prints the result of a test program
+ *
+ * \param name Name of the test
+ *
+ * \return Exit status for main()
+ */
+static inline int testResult(const char *name)
+{
+    printf("%s: %s (%d failed)\n", name, testFailures ? "FAIL" : "PASS", testFailures);
+    return testFailures ? 1 : 0;
+}
+
+#endif /* TEST_H_ */
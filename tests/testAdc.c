@@ -0,0 +1,283 @@
+/*! \file */
+/*!
+ * testAdc.c
+ *
+ * Description: Runs the ADC14 frame scan on a simulated converter that
+ *              adds noise to a known level on every input, and checks the
+ *              sequence plan and the resolution the oversampling and
+ *              decimation add: a frame sample has to land closer to the
+ *              level than a single 10-bit conversion does.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include <math.h>
+#include "test.h"
+#include "adc.h"
+
+#define INPUTS          32
+#define LEVEL_STEPS     64              // Levels per sweep, 1/32 count apart
+#define SWEEP_FRAMES    64              // Frames per level
+
+extern void ADC14_IRQHandler(void);
+
+static double inputLevel[INPUTS];       // Level on each ADC14 input (counts)
+static double inputNoise;               // Standard deviation of the noise (counts)
+static uint32_t noiseState = 1;
+
+/*!
+ * Pseudo-random noise, the same on every host
+ *
+ * \return Roughly normal value, standard deviation 1
+ */
+static double noise(void)
+{
+    double sum = 0;
+    uint8_t i;
+
+    // Sum of four uniform values, scaled to a standard deviation of 1
+    for (i = 0; i < 4; i++)
+    {
+        noiseState = noiseState * 1103515245 + 12345;
+        sum += (double)(noiseState >> 8) / (1 << 24) - 0.5;
+    }
+    return sum * sqrt(3.0);
+}
+
+/*!
+ * One 10-bit conversion of an input
+ *
+ * \param input ADC14 input channel
+ *
+ * \return Result (counts)
+ */
+static uint16_t convert(uint8_t input)
+{
+    double level = floor(inputLevel[input] + inputNoise * noise() + 0.5);
+
+    return (level < 0) ? 0 : (level > MAX_VAL) ? MAX_VAL : (uint16_t)level;
+}
+
+/*!
+ * Raises the window interrupt if a conversion falls below its window,
+ *  while the later ADC14MEMx still hold the sequence before
+ *
+ * \param slot ADC14MEMx just converted
+ *
+ * \return None
+ */
+static void compareWindow(uint8_t slot)
+{
+    uint32_t mctl = ADC14->MCTL[slot];
+    uint32_t lo = (mctl & ADC14_MCTLN_WINCTH) ? ADC14->LO1 : ADC14->LO0;
+
+    if ((mctl & ADC14_MCTLN_WINC) && ADC14->MEM[slot] < lo && (ADC14->IER1 & ADC14_IER1_LOIE))
+    {
+        *(volatile uint32_t *)&ADC14->IFGR1 |= ADC14_IFGR1_LOIFG;
+        ADC14_IRQHandler();
+        *(volatile uint32_t *)&ADC14->IFGR1 &= ~ADC14_IFGR1_LOIFG;
+    }
+}
+
+/*!
+ * Starts the next sequence the way the Timer_A0 CCR2 match does, then runs
+ *  it to the end and lets the DMA copy the results
+ *
+ * \return None
+ */
+static void runSequence(void)
+{
+    DmaControlEntry *dma = DMA_PRIMARY(ADC_DMA_CHANNEL);
+    volatile uint32_t *src;
+    uint16_t *dst;
+    uint16_t count, i;
+    uint8_t slot = 0;
+
+    TIMER_A0->R = TIMER_A0->CCR[2];
+    startAdcFrame();
+    if (!(ADC14->CTL0 & ADC14_CTL0_SC))
+    {
+        return;
+    }
+    ADC14->CTL0 &= ~ADC14_CTL0_SC;
+
+    do
+    {
+        ADC14->MEM[slot] = convert(ADC14->MCTL[slot] & ADC14_MCTLN_INCH_MASK);
+        compareWindow(slot);
+    } while (!(ADC14->MCTL[slot++] & ADC14_MCTLN_EOS));
+
+    count = DMA_TRANSFERS_LEFT(dma->control);
+    src = (volatile uint32_t *)dma->srcEnd - (count - 1);
+    dst = (uint16_t *)dma->dstEnd - (count - 1);
+    for (i = 0; i < count; i++)
+    {
+        dst[i] = src[i];
+    }
+    DMA_Control->ENASET &= ~(1 << ADC_DMA_CHANNEL);
+}
+
+/*!
+ * Runs the scan until the next frame is complete
+ *
+ * \return The frame
+ */
+static const AdcFrame *nextFrame(void)
+{
+    uint32_t frames = adcFrameCount();
+
+    while (adcFrameCount() == frames)
+    {
+        runSequence();
+    }
+    return adcFrame(0);
+}
+
+/*!
+ * Sweeps the level of every input over a count, and measures how far the
+ *  frame samples of one channel and single conversions are from the level
+ *
+ * \param channel Position in adcChannels
+ * \param frame   Receives the RMS error of the frame samples (counts)
+ * \param single  Receives the RMS error of single conversions (counts)
+ *
+ * \return None
+ */
+static void sweep(uint8_t channel, double *frame, double *single)
+{
+    uint8_t input = adcChannels[channel].input;
+    double error, frameSum = 0, singleSum = 0;
+    uint32_t step, n;
+
+    for (step = 0; step < LEVEL_STEPS; step++)
+    {
+        for (n = 0; n < INPUTS; n++)
+        {
+            inputLevel[n] = 300.0 + (double)step / LEVEL_STEPS;
+        }
+        // The frame in progress still has conversions of the old level
+        nextFrame();
+        for (n = 0; n < SWEEP_FRAMES; n++)
+        {
+            error = (double)nextFrame()->sample[channel] / (1 << ADC_SAMPLE_FRAC) - inputLevel[input];
+            frameSum += error * error;
+            error = convert(input) - inputLevel[input];
+            singleSum += error * error;
+        }
+    }
+    *frame = sqrt(frameSum / (LEVEL_STEPS * SWEEP_FRAMES));
+    *single = sqrt(singleSum / (LEVEL_STEPS * SWEEP_FRAMES));
+}
+
+/*!
+ * With noise of half a count the frame samples of each channel have to
+ *  gain at least most of the bits its conversions per frame allow
+ *
+ * \return None
+ */
+static void testResolution(void)
+{
+    double frame, single, bits, expected;
+    uint8_t i;
+
+    inputNoise = 0.5;
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        sweep(i, &frame, &single);
+        bits = log2(single / frame);
+
+        // Each doubling of the conversions halves the noise power, so 4^n
+        //  conversions give n bits. The photoresistors are converted in
+        //  both sequences of the frame, which is half a bit.
+        expected = (adcChannels[i].oversample > 0) ? adcChannels[i].oversample : 0.5;
+        printf("channel %u: RMS error %.3f counts per frame, %.3f per conversion, %.2f bits gained\n",
+               i, frame, single, bits);
+        CHECK(bits > expected - 0.3, "channel %u gained %.2f bits, expected %.1f", i, bits, expected);
+    }
+}
+
+/*!
+ * A steady level without noise has to come out exactly, with nothing lost
+ *  in the sums or the decimation
+ *
+ * \return None
+ */
+static void testSteadyLevel(void)
+{
+    const AdcFrame *frame = NULL;
+    uint8_t i, n;
+
+    inputNoise = 0;
+    for (n = 0; n < INPUTS; n++)
+    {
+        inputLevel[n] = (n % 2) ? 1023 : 5;
+    }
+    for (n = 0; n < 4; n++)
+    {
+        frame = nextFrame();
+    }
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        CHECK(frame->sample[i] == ADC_SAMPLE((uint32_t)inputLevel[adcChannels[i].input]),
+              "channel %u read %u, expected %u", i, frame->sample[i],
+              ADC_SAMPLE((uint32_t)inputLevel[adcChannels[i].input]));
+    }
+}
+
+/*!
+ * The first photoresistor goes dark while the second one's ADC14MEMx still
+ *  holds a dark reading from the sequence before. Only the first may be
+ *  taken as dark.
+ *
+ * \return None
+ */
+static void testWindowAttribution(void)
+{
+    uint8_t photo = adcChannels[ADC_SAMPLE_PHOTO].input;
+    uint8_t photo2 = adcChannels[ADC_SAMPLE_PHOTO_2].input;
+    WinEvent event;
+    uint32_t n;
+
+    inputNoise = 0.5;
+    for (n = 0; n < INPUTS; n++)
+    {
+        inputLevel[n] = 800;
+    }
+    learnAmbientLight();
+    for (n = 0; n < 3000; n++)
+    {
+        nextFrame();
+    }
+
+    // One dark sequence on the second sensor before the round, left in its
+    //  ADC14MEMx
+    inputLevel[photo2] = 100;
+    runSequence();
+    inputLevel[photo2] = 800;
+    armWinDetect();
+
+    inputLevel[photo] = 100;
+    for (n = 0; n < 2 * WIN_TRANSIT_FRAMES && !winDetected(&event); n++)
+    {
+        nextFrame();
+    }
+    CHECK(winDetected(&event), "no win after %u frames", n);
+    CHECK(event.darkened == WIN_PHOTO, "sensors 0x%X taken as dark, expected 0x%X", event.darkened,
+          WIN_PHOTO);
+    CHECK(event.sensors == WIN_PHOTO, "sensors 0x%X confirmed, expected 0x%X", event.sensors, WIN_PHOTO);
+}
+
+int main(void)
+{
+    configureADC14();
+
+    // The default table takes 2 sequences of 18, see adc.h
+    printf("%u conversions per sequence\n", adcSequenceLength);
+    CHECK(adcSequenceLength == 18, "%u conversions per sequence, expected 18", adcSequenceLength);
+
+    testSteadyLevel();
+    testResolution();
+    testWindowAttribution();
+    return testResult("adc");
+}
@@ -0,0 +1,175 @@
+/*! \file */
+/*!
+ * testJoystickFilter.c
+ *
+ * Description: Feeds synthetic joystick traces through the joystick filter:
+ *              rest noise with spikes, a slow push through the dead-zone
+ *              thresholds, full throws and a release, and an off-centre
+ *              rest position.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "test.h"
+#include "joystickFilter.h"
+
+#define REST            512
+#define SAMPLE(counts)  ((uint16_t)((counts) << JOY_SAMPLE_FRAC))
+#define FULL_OUTPUT     (JOY_FULL_DEFLECTION << JOY_DEFLECT_FRAC)
+
+// Three-sample median, 1/16 IIR, dead-zone entered within 6 and left beyond 18 counts
+static const JoystickFilterConfig config = { 3, 4, 6, 18, 13 };
+
+static uint32_t noiseState = 1;
+
+/*!
+ * Pseudo-random noise, the same on every host
+ *
+ * \param amplitude Largest deviation (counts)
+ *
+ * \return Value from -amplitude to amplitude
+ */
+static int32_t noise(int32_t amplitude)
+{
+    noiseState = noiseState * 1103515245 + 12345;
+    return (int32_t)((noiseState >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+/*!
+ * Resting stick with noise and single-sample spikes to either rail must
+ *  stay in the dead-zone
+ *
+ * \return None
+ */
+static void testRestNoise(void)
+{
+    JoystickFilter filter;
+    int16_t out;
+    int32_t i, moved = 0;
+
+    initJoystickFilter(&filter, &config, REST);
+    for (i = 0; i < 5000; i++)
+    {
+        int32_t counts = REST + noise(15);
+
+        if (i % 97 == 0)
+        {
+            counts = (i % 2) ? 1023 : 0;
+        }
+        out = filterJoystick(&filter, SAMPLE(counts));
+        moved += (out != 0);
+    }
+    CHECK(moved == 0, "%d of 5000 resting samples reported a deflection", moved);
+}
+
+/*!
+ * Pushing slowly through the thresholds with noise leaves the dead-zone
+ *  once, near the exit band, and never comes back while held there
+ *
+ * \return None
+ */
+static void testSlowPush(void)
+{
+    JoystickFilter filter;
+    int16_t out, last = 0;
+    int32_t i, flips = 0, firstMove = -1;
+
+    initJoystickFilter(&filter, &config, REST);
+    for (i = 0; i < 3000; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(REST + i / 100 + noise(5)));
+        if ((out != 0) != (last != 0))
+        {
+            flips++;
+            if (firstMove < 0)
+            {
+                firstMove = i / 100;
+            }
+        }
+        last = out;
+    }
+    CHECK(flips == 1, "%d dead-zone changes on a slow push", flips);
+    CHECK(firstMove >= config.exitBand - 5 && firstMove <= config.exitBand + 5,
+          "left the dead-zone at %d counts", firstMove);
+    CHECK(last >= config.activeBand << JOY_DEFLECT_FRAC, "deflection %d below the active band", last);
+}
+
+/*!
+ * Full throws both ways reach the full deflection, and releasing the stick
+ *  returns to the dead-zone
+ *
+ * \return None
+ */
+static void testFullThrow(void)
+{
+    JoystickFilter filter;
+    int16_t out = 0;
+    int32_t i;
+
+    initJoystickFilter(&filter, &config, REST);
+    setJoystickRange(&filter, REST, 0, 1023);
+    for (i = 0; i < 200; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(1023 + noise(3) - 3));
+    }
+    CHECK(out >= FULL_OUTPUT * 98 / 100, "full throw up gave %d", out);
+
+    for (i = 0; i < 200; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(noise(3) + 3));
+    }
+    CHECK(out <= -FULL_OUTPUT * 98 / 100, "full throw down gave %d", out);
+
+    for (i = 0; i < 200 && out != 0; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(REST + noise(5)));
+    }
+    CHECK(out == 0, "still deflected %d after release", out);
+    CHECK(i < 100, "took %d samples to settle after release", i);
+}
+
+/*!
+ * With the rest position off-centre, both sides still reach the full
+ *  deflection at their own extremes, and the output is proportional in
+ *  between
+ *
+ * \return None
+ */
+static void testOffCentre(void)
+{
+    JoystickFilter filter;
+    int16_t out = 0;
+    int32_t i;
+
+    initJoystickFilter(&filter, &config, 600);
+    setJoystickRange(&filter, 600, 100, 1000);
+
+    for (i = 0; i < 300; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(1000));
+    }
+    CHECK(out >= FULL_OUTPUT - 16, "short side gave %d", out);
+
+    for (i = 0; i < 300; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(100));
+    }
+    CHECK(out <= -(FULL_OUTPUT - 16), "long side gave %d", out);
+
+    // Half way to the short side's extreme
+    for (i = 0; i < 300; i++)
+    {
+        out = filterJoystick(&filter, SAMPLE(800));
+    }
+    CHECK(out > FULL_OUTPUT * 45 / 100 && out < FULL_OUTPUT * 55 / 100, "half throw gave %d", out);
+}
+
+int main(void)
+{
+    testRestNoise();
+    testSlowPush();
+    testFullThrow();
+    testOffCentre();
+    return testResult("joystickFilter");
+}
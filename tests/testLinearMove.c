@@ -0,0 +1,157 @@
+/*! \file */
+/*!
+ * testLinearMove.c
+ *
+ * Description: Replays linear moves on the simulated step timer and checks
+ *              the emitted step sequence of both axes: the coils always
+ *              show the sequence position, no compare skips steps, the
+ *              path stays within a stride of the line and both axes arrive
+ *              together. The minor axis takes one half-step per compare,
+ *              at least STEPPER_STAGGER_GUARD apart. An early stop must end
+ *              the move so the next one can start.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "test.h"
+#include "stepperSim.h"
+
+#define MAX_TICKS       400000
+
+/*!
+ * Checks that the coils of an axis show its sequence position and that
+ *  the position moved by at most one stride (two half-steps in full-step
+ *  mode) since the last compare
+ *
+ * \param axis Axis to check
+ * \param last Position at the last compare, updated
+ *
+ * \return None
+ */
+static void checkStep(uint8_t axis, int32_t *last)
+{
+    StepperAxis *a = &stepperAxes[axis];
+    int32_t moved = a->position - *last;
+
+    CHECK(moved >= -2 && moved <= 2, "axis %u moved %d steps in one compare", axis, moved);
+    if (a->coilState == COILS_FULL)
+    {
+        CHECK((*a->config->out & a->mask) == a->pattern[a->currentStep],
+              "axis %u drives 0x%02X at sequence position %u", axis, *a->config->out & a->mask,
+              a->currentStep);
+    }
+    *last = a->position;
+}
+
+/*!
+ * Runs a linear move to its end point
+ *
+ * \param x0 Horizontal start position
+ * \param y0 Vertical start position
+ * \param dx Horizontal distance
+ * \param dy Vertical distance
+ *
+ * \return None
+ */
+static void testLine(int32_t x0, int32_t y0, int32_t dx, int32_t dy)
+{
+    int32_t last[NUM_STEPPERS];
+    int64_t error, worst = 0;
+    int32_t major = (dx < 0 ? -dx : dx) >= (dy < 0 ? -dy : dy) ? (dx < 0 ? -dx : dx) : (dy < 0 ? -dy : dy);
+    uint8_t minor = ((dx < 0 ? -dx : dx) >= (dy < 0 ? -dy : dy)) ? STEPPER_Y : STEPPER_X;
+    int32_t minorLast = (minor == STEPPER_X) ? x0 : y0;
+    uint64_t minorEdge = 0, gap, minorGap = UINT64_MAX;
+    uint32_t ticks = 0;
+
+    simInitSteppers();
+    stepperAxes[STEPPER_X].position = x0;
+    stepperAxes[STEPPER_Y].position = y0;
+    last[STEPPER_X] = x0;
+    last[STEPPER_Y] = y0;
+
+    CHECK(moveSteppersLinear(dx, dy, RPM_TO_PERIOD(MAX_RPM)), "move (%d, %d) refused", dx, dy);
+    stubBitbandSync();
+    while (linearMoveActive() && ticks < MAX_TICKS && simTick() != SIM_NO_COMPARE)
+    {
+        ticks++;
+        checkStep(STEPPER_X, &last[STEPPER_X]);
+        checkStep(STEPPER_Y, &last[STEPPER_Y]);
+
+        if (stepperAxes[minor].position != minorLast)
+        {
+            CHECK(stepperAxes[minor].position - minorLast == 1 || minorLast - stepperAxes[minor].position == 1,
+                  "minor axis moved %d steps in one compare", stepperAxes[minor].position - minorLast);
+            gap = simTime - minorEdge;
+            if (minorEdge != 0 && gap < minorGap)
+            {
+                minorGap = gap;
+            }
+            minorEdge = simTime;
+            minorLast = stepperAxes[minor].position;
+        }
+
+        // Distance from the line, in steps of the minor axis. Its steps
+        //  follow a full-step stride of the major axis a little later, at
+        //  its own compare, so the path may lag by two half-steps.
+        error = (int64_t)(stepperAxes[STEPPER_Y].position - y0) * dx
+                - (int64_t)(stepperAxes[STEPPER_X].position - x0) * dy;
+        error = (error < 0 ? -error : error) / major;
+        if (error > worst)
+        {
+            worst = error;
+        }
+    }
+
+    CHECK(!linearMoveActive(), "move (%d, %d) still active after %u compares", dx, dy, ticks);
+    CHECK(stepperAxes[STEPPER_X].position == x0 + dx && stepperAxes[STEPPER_Y].position == y0 + dy,
+          "move (%d, %d) ended at (%d, %d)", dx, dy,
+          stepperAxes[STEPPER_X].position - x0, stepperAxes[STEPPER_Y].position - y0);
+    CHECK(worst <= 2, "move (%d, %d) strayed %d steps from the line", dx, dy, (int)worst);
+    CHECK(minorGap >= STEPPER_STAGGER_GUARD, "move (%d, %d) minor edges %u ticks apart", dx, dy,
+          (unsigned)minorGap);
+    CHECK(stepperAtRest(STEPPER_X) && stepperAtRest(STEPPER_Y), "axes still moving");
+}
+
+/*!
+ * Stops the major axis half way through a move. The move has to end with
+ *  the minor axis disarmed, and the next move must be accepted.
+ *
+ * \return None
+ */
+static void testEarlyStop(void)
+{
+    StepperAxis *minor = &stepperAxes[STEPPER_Y];
+    uint32_t ticks = 0;
+
+    simInitSteppers();
+    CHECK(moveSteppersLinear(6000, 4000, RPM_TO_PERIOD(MAX_RPM)), "move refused");
+    stubBitbandSync();
+    while (stepperAxes[STEPPER_X].position < 3000 && ticks++ < MAX_TICKS)
+    {
+        simTick();
+    }
+
+    disableStepperMotor(STEPPER_X);
+    while (!(stepperAtRest(STEPPER_X) && stepperAtRest(STEPPER_Y)) && ticks++ < MAX_TICKS)
+    {
+        simTick();
+    }
+
+    CHECK(!linearMoveActive(), "move still active after the major axis stopped");
+    CHECK(minor->deferredSteps == 0, "%u minor steps still deferred", minor->deferredSteps);
+    CHECK(!(STEPPER_TIMER->CCTL[minor->config->ccr] & TIMER_A_CCTLN_CCIE), "minor compare armed");
+    CHECK(moveSteppersLinear(-stepperAxes[STEPPER_X].position, -stepperAxes[STEPPER_Y].position,
+                             RPM_TO_PERIOD(MAX_RPM)), "next move refused");
+}
+
+int main(void)
+{
+    testLine(7000, 2500, -7000, -2500);
+    testLine(0, 0, 6000, 4000);
+    testLine(0, 0, 1200, 5000);
+    testLine(3000, 3000, 500, -500);
+    testLine(100, 0, 0, 3000);
+    testEarlyStop();
+    return testResult("linearMove");
+}
@@ -0,0 +1,157 @@
+/*! \file */
+/*!
+ * testPhotoSensor.c
+ *
+ * Description: Feeds synthetic light traces through the photoresistor
+ *              tracker: it learns the ambient level, then sees either a
+ *              prize dropping past it or only flicker and short dips that
+ *              must not count as a drop.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "test.h"
+#include "photoSensor.h"
+
+#define START_THRESHOLD     150         // Fixed threshold the tracker replaced
+#define LEARN_FRAMES        3000        // About 3 s of ADC frames
+#define WATCH_FRAMES        5000
+#define DROP_FRAME          2000        // Frame the prize starts covering the sensor
+#define NO_DROP             -1
+
+typedef struct
+{
+    const char *name;
+    int32_t ambient;            // Light level (counts)
+    int32_t noise;              // Largest deviation from it (counts)
+    int32_t flickerEvery;       // Frames between flicker dips, 0 for none
+    int32_t flickerDepth;       // Depth of a flicker dip (counts)
+    int32_t dipEvery;           // Frames between two-frame dips, 0 for none
+    int32_t dropLevel;          // Level with the prize in front, NO_DROP for none
+} LightTrace;
+
+static uint32_t noiseState = 1;
+
+/*!
+ * Pseudo-random noise, the same on every host
+ *
+ * \param amplitude Largest deviation (counts)
+ *
+ * \return Value from -amplitude to amplitude
+ */
+static int32_t noise(int32_t amplitude)
+{
+    noiseState = noiseState * 1103515245 + 12345;
+    return (int32_t)((noiseState >> 16) % (2 * amplitude + 1)) - amplitude;
+}
+
+/*!
+ * Reading of a trace at a frame
+ *
+ * \param trace Trace to sample
+ * \param frame Frame number
+ * \param drop  true once the prize covers the sensor
+ *
+ * \return ADC reading
+ */
+static uint16_t sample(const LightTrace *trace, int32_t frame, bool drop)
+{
+    int32_t level = drop ? trace->dropLevel : trace->ambient;
+
+    level += noise(trace->noise);
+    if (!drop && trace->flickerEvery != 0 && frame % trace->flickerEvery == 0)
+    {
+        level -= trace->flickerDepth;
+    }
+    if (!drop && trace->dipEvery != 0 && frame % trace->dipEvery < PHOTO_CONFIRM / 2)
+    {
+        level = trace->ambient / 4;
+    }
+    return (level < 0) ? 0 : (level > 1023) ? 1023 : level;
+}
+
+/*!
+ * Learns a trace, then watches it for a drop
+ *
+ * \param trace Trace to run
+ *
+ * \return None
+ */
+static void testTrace(const LightTrace *trace)
+{
+    PhotoSensor sensor;
+    bool dropping;
+    int32_t frame, detectedAt = -1, falseCount = 0;
+    uint8_t restConfidence = 0;
+
+    initPhotoSensor(&sensor, START_THRESHOLD);
+    for (frame = 0; frame < LEARN_FRAMES; frame++)
+    {
+        updatePhotoSensor(&sensor, sample(trace, frame, false), true);
+    }
+
+    for (frame = 0; frame < WATCH_FRAMES; frame++)
+    {
+        dropping = (trace->dropLevel != NO_DROP && frame >= DROP_FRAME);
+        if (updatePhotoSensor(&sensor, sample(trace, frame, dropping), false))
+        {
+            if (!dropping)
+            {
+                falseCount++;
+            }
+            else if (detectedAt < 0)
+            {
+                detectedAt = frame - DROP_FRAME;
+            }
+        }
+        if (!dropping && sensor.confidence > restConfidence && trace->flickerEvery == 0
+            && trace->dipEvery == 0)
+        {
+            restConfidence = sensor.confidence;
+        }
+    }
+
+    printf("%s: threshold %u, %d false detections", trace->name, sensor.threshold, falseCount);
+    if (detectedAt >= 0)
+    {
+        printf(", drop detected after %d frames", detectedAt);
+    }
+    printf("\n");
+    CHECK(falseCount == 0, "%s: %d false detections", trace->name, falseCount);
+    CHECK(restConfidence < PHOTO_CONFIDENCE_MAX / 4, "%s: confidence %u at rest", trace->name,
+          restConfidence);
+    if (trace->dropLevel != NO_DROP)
+    {
+        CHECK(detectedAt >= PHOTO_CONFIRM - 1 && detectedAt <= PHOTO_CONFIRM + 2,
+              "%s: detected after %d frames", trace->name, detectedAt);
+        CHECK(sensor.confidence > PHOTO_CONFIDENCE_MAX / 2, "%s: confidence %u covered",
+              trace->name, sensor.confidence);
+    }
+    else
+    {
+        CHECK(detectedAt < 0, "%s: drop detected", trace->name);
+    }
+}
+
+int main(void)
+{
+    static const LightTrace traces[] =
+    {
+        // Name             ambient noise flicker depth  dips   drop
+        { "bright arcade",    900,    6,     0,     0,     0,    350 },
+        { "bright, no drop",  900,    6,     0,     0,     0, NO_DROP },
+        { "dim room",         260,    4,     0,     0,     0,     90 },
+        { "claw shadow",      180,    3,     0,     0,     0,     40 },
+        { "flicker",          600,    4,    10,   250,     0, NO_DROP },
+        { "flicker + drop",   600,    4,    10,   250,     0,    100 },
+        { "short dips",       600,    4,     0,     0,   500, NO_DROP },
+    };
+    uint8_t i;
+
+    for (i = 0; i < sizeof(traces) / sizeof(traces[0]); i++)
+    {
+        testTrace(&traces[i]);
+    }
+    return testResult("photoSensor");
+}
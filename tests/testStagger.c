@@ -0,0 +1,354 @@
+/*! \file */
+/*!
+ * testStagger.c
+ *
+ * Description: Records the coil edge timeline of both stepper axes and the
+ *              servo on the simulated timers, and reports the worst gap
+ *              between edges of different outputs. Edges closer than
+ *              STEPPER_STAGGER_GUARD count as coincident. Staggering must
+ *              not cost more than 1% of the requested speed, and the
+ *              time steps are pushed back must be made up rather than pile
+ *              up.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "test.h"
+#include "stepperSim.h"
+#include "servoDriver.h"
+
+#define MAX_EDGES           20000
+#define EDGE_OUTPUTS        3               // STEPPER_X, STEPPER_Y, servo
+#define EDGE_SERVO          2
+#define SERVO_PERIOD_TICKS  ((uint32_t)(SERVO_TMR_PERIOD) * SERVO_TO_STEPPER_TICKS)
+
+extern void TA2_0_IRQHandler(void);
+extern volatile bool pulsePending;
+
+typedef struct
+{
+    uint64_t time[MAX_EDGES];
+    uint32_t count;
+} EdgeLog;
+
+static EdgeLog edges[EDGE_OUTPUTS];
+static uint8_t lastCoils[NUM_STEPPERS];
+static uint32_t worstDebt[NUM_STEPPERS];
+
+/*!
+ * Adds an edge to a log
+ *
+ * \param output STEPPER_X, STEPPER_Y or EDGE_SERVO
+ * \param time   Moment of the edge
+ *
+ * \return None
+ */
+static void logEdge(uint8_t output, uint64_t time)
+{
+    EdgeLog *log = &edges[output];
+
+    if (log->count < MAX_EDGES)
+    {
+        log->time[log->count++] = time;
+    }
+}
+
+/*!
+ * Logs an edge for every axis whose coils changed in the last compare
+ *
+ * \param ccr Compare register that was serviced
+ *
+ * \return None
+ */
+static void recordCoils(uint8_t ccr)
+{
+    uint8_t axis, coils;
+
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        coils = *stepperAxes[axis].config->out & stepperAxes[axis].mask;
+        if (coils != lastCoils[axis])
+        {
+            logEdge(axis, simTime);
+            lastCoils[axis] = coils;
+        }
+        if (stepperAxes[axis].staggerDebt > worstDebt[axis])
+        {
+            worstDebt[axis] = stepperAxes[axis].staggerDebt;
+        }
+    }
+}
+
+/*!
+ * Starts a fresh timeline
+ *
+ * \return None
+ */
+static void clearEdges(void)
+{
+    uint8_t axis;
+
+    for (axis = 0; axis < EDGE_OUTPUTS; axis++)
+    {
+        edges[axis].count = 0;
+    }
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        lastCoils[axis] = *stepperAxes[axis].config->out & stepperAxes[axis].mask;
+        worstDebt[axis] = 0;
+    }
+}
+
+/*!
+ * Counts the edges of one output that are closer than STEPPER_STAGGER_GUARD
+ *  to an edge of another
+ *
+ * \param a     First output
+ * \param b     Second output
+ * \param worst Smallest gap found, updated
+ *
+ * \return Number of coincident edges of \a a
+ */
+static uint32_t coincidentEdges(uint8_t a, uint8_t b, uint64_t *worst)
+{
+    const EdgeLog *la = &edges[a];
+    const EdgeLog *lb = &edges[b];
+    uint32_t i, j = 0, count = 0;
+    uint64_t gap, nearest;
+
+    for (i = 0; i < la->count; i++)
+    {
+        // Both logs are in time order
+        while (j + 1 < lb->count && lb->time[j + 1] <= la->time[i])
+        {
+            j++;
+        }
+        if (lb->count == 0)
+        {
+            break;
+        }
+        nearest = (lb->time[j] > la->time[i]) ? lb->time[j] - la->time[i] : la->time[i] - lb->time[j];
+        if (j + 1 < lb->count)
+        {
+            gap = lb->time[j + 1] - la->time[i];
+            if (gap < nearest)
+            {
+                nearest = gap;
+            }
+        }
+        if (nearest < *worst)
+        {
+            *worst = nearest;
+        }
+        if (nearest < STEPPER_STAGGER_GUARD)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*!
+ * Runs both axes until they stop, changing the servo angle every other PWM
+ *  period, and checks the timeline since clearEdges() for coincident edges
+ *
+ * \param name Name of the run
+ *
+ * \return None
+ */
+static void runAndCheck(const char *name)
+{
+    uint64_t servoTime = simTime, worst = UINT64_MAX;
+    uint32_t periods = 0, coincident, forced = 0;
+    uint8_t deferrals = 0;
+
+    while (!(stepperAtRest(STEPPER_X) && stepperAtRest(STEPPER_Y)) && periods < 2000)
+    {
+        servoTime += SERVO_PERIOD_TICKS;
+        simRunUntil(servoTime);
+
+        // Start of a PWM period, the new width's falling edge follows
+        if ((periods++ & 1) == 0 && !pulsePending)
+        {
+            setServoAngle((periods & 2) ? MIN_ANGLE : MAX_ANGLE);
+        }
+        if (pulsePending)
+        {
+            TA2_0_IRQHandler();
+            if (pulsePending)
+            {
+                deferrals++;
+            }
+            else
+            {
+                forced += (deferrals > SERVO_MAX_DEFER);
+                deferrals = 0;
+                logEdge(EDGE_SERVO, simTime + (uint32_t)TIMER_A2->CCR[1] * SERVO_TO_STEPPER_TICKS);
+            }
+        }
+    }
+
+    coincident = coincidentEdges(STEPPER_X, STEPPER_Y, &worst);
+    printf("%s: %u + %u step edges, %u coincident, worst gap %u ticks\n", name,
+           edges[STEPPER_X].count, edges[STEPPER_Y].count, coincident, (unsigned)worst);
+    CHECK(coincident == 0, "%s: %u coincident step edges", name, coincident);
+
+    worst = UINT64_MAX;
+    coincident = coincidentEdges(EDGE_SERVO, STEPPER_X, &worst)
+                 + coincidentEdges(EDGE_SERVO, STEPPER_Y, &worst);
+    printf("%s: %u servo edges, %u coincident (%u forced), worst gap %u ticks\n", name,
+           edges[EDGE_SERVO].count, coincident, forced, (unsigned)worst);
+    CHECK(coincident <= forced, "%s: %u servo edges coincident, %u forced", name, coincident, forced);
+}
+
+/*!
+ * Both axes move on their own at full speed
+ *
+ * \return None
+ */
+static void testIndependent(void)
+{
+    simInitSteppers();
+    moveStepperTo(STEPPER_X, 6000, RPM_TO_PERIOD(MAX_RPM));
+    moveStepperTo(STEPPER_Y, 6000, RPM_TO_PERIOD(MAX_RPM));
+    stubBitbandSync();
+    clearEdges();
+    runAndCheck("independent");
+}
+
+/*!
+ * A linear move steps the minor axis from the major axis's interrupt
+ *
+ * \return None
+ */
+static void testLinear(void)
+{
+    simInitSteppers();
+    moveSteppersLinear(6000, 4000, RPM_TO_PERIOD(MAX_RPM));
+    stubBitbandSync();
+    clearEdges();
+    runAndCheck("linear");
+}
+
+/*!
+ * Both axes cruise at the same period, where their edges would line up
+ *  without staggering. The average speed has to stay within 1%.
+ *
+ * \param rpm Cruise speed
+ *
+ * \return None
+ */
+static void testSameSpeed(uint8_t rpm)
+{
+    int32_t start[NUM_STEPPERS];
+    uint64_t startTime;
+    double expected;
+    uint8_t axis;
+
+    simInitSteppers();
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        setStepMode(axis, STEP_MODE_HALF);
+        setDirection(axis, !stepperAxes[axis].config->homeDirection);
+        setStepPeriod(axis, RPM_TO_PERIOD(rpm));
+        enableStepperMotor(axis);
+    }
+    stubBitbandSync();
+
+    // Past the ramp, then measure over a second
+    simRunUntil(simTime + CLK_RATE);
+    clearEdges();
+    startTime = simTime;
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        start[axis] = stepperAxes[axis].position;
+    }
+    simRunUntil(simTime + CLK_RATE);
+    expected = (double)(simTime - startTime) / RPM_TO_PERIOD(rpm);
+
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        int32_t steps = stepperAxes[axis].position - start[axis];
+
+        CHECK(steps > expected * 0.99 && steps < expected * 1.01,
+              "axis %u took %d steps at %u RPM, expected %.1f", axis, steps, rpm, expected);
+    }
+
+    disableStepperMotor(STEPPER_X);
+    disableStepperMotor(STEPPER_Y);
+    runAndCheck("same speed");
+}
+
+/*!
+ * Both axes cruise at full speed and the same period while the servo moves
+ *  every PWM period, so every step edge contends with two other outputs.
+ *  The stagger debt has to stay below a period, and the speed within 1%.
+ *
+ * \return None
+ */
+static void testContention(void)
+{
+    uint32_t period = RPM_TO_PERIOD(MAX_RPM);
+    int32_t start[NUM_STEPPERS];
+    uint64_t startTime, servoTime;
+    uint32_t periods = 0;
+    double expected;
+    uint8_t axis;
+
+    simInitSteppers();
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        setStepMode(axis, STEP_MODE_HALF);
+        setDirection(axis, !stepperAxes[axis].config->homeDirection);
+        setStepPeriod(axis, period);
+        enableStepperMotor(axis);
+    }
+    stubBitbandSync();
+
+    // Past the ramp, then measure over four seconds, short of the soft limit
+    simRunUntil(simTime + CLK_RATE);
+    clearEdges();
+    startTime = servoTime = simTime;
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        start[axis] = stepperAxes[axis].position;
+    }
+    while (servoTime < startTime + 4ULL * CLK_RATE)
+    {
+        servoTime += SERVO_PERIOD_TICKS;
+        simRunUntil(servoTime);
+        if (!pulsePending)
+        {
+            setServoAngle((periods++ & 1) ? MIN_ANGLE : MAX_ANGLE);
+        }
+        TA2_0_IRQHandler();
+    }
+    expected = (double)(simTime - startTime) / period;
+
+    for (axis = 0; axis < NUM_STEPPERS; axis++)
+    {
+        int32_t steps = stepperAxes[axis].position - start[axis];
+
+        printf("contention: axis %u took %d steps, expected %.1f, worst debt %u ticks\n", axis, steps,
+               expected, worstDebt[axis]);
+        CHECK(worstDebt[axis] < period, "axis %u stagger debt reached %u ticks, period %u", axis,
+              worstDebt[axis], period);
+        CHECK(steps > expected * 0.99 && steps < expected * 1.01,
+              "axis %u took %d steps under contention, expected %.1f", axis, steps, expected);
+    }
+
+    disableStepperMotor(STEPPER_X);
+    disableStepperMotor(STEPPER_Y);
+}
+
+int main(void)
+{
+    simSetHook(recordCoils);
+    testIndependent();
+    testLinear();
+    testSameSpeed(10);
+    testSameSpeed(MAX_RPM);
+    testContention();
+    return testResult("stagger");
+}
@@ -0,0 +1,169 @@
+/*! \file */
+/*!
+ * testStepperRamp.c
+ *
+ * Description: Replays the ramp generator the way the step interrupt calls
+ *              it, one rampNextPeriod() per step on a simulated clock, and
+ *              checks the rate against the pull-in and acceleration limits.
+ *
+ *  Created on: 10/16/2026
+ *      Author: agent
+ */
+
+#include "test.h"
+#include "stepperRamp.h"
+
+#define START_PERIOD    (RAMP_CLK_RATE / RAMP_START_RATE)
+#define CRUISE_PERIOD   2929            // About 1365 steps/s
+#define MAX_STEPS       20000
+
+/*!
+ * Largest rate change (Q8) the ramp may make over a step of \a period
+ *
+ * \param maxAccel Acceleration limit (steps/s^2)
+ * \param period   Period of the step (ticks)
+ *
+ * \return Rate change, plus one for rounding
+ */
+static uint32_t maxRateChange(uint16_t maxAccel, uint32_t period)
+{
+    return (uint32_t)(((uint64_t)maxAccel * period) / RAMP_TICKS_PER_SEC_Q) + 1;
+}
+
+/*!
+ * Steps the ramp until it stops or MAX_STEPS have passed, checking every
+ *  rate change against the acceleration limit. Above the pull-in rate the
+ *  rate may only move as far as the limit allows over the step just taken;
+ *  leaving a step slower than pull-in it may not exceed the pull-in rate.
+ *
+ * \param ramp   Ramp state, already started
+ * \param period Period returned by startRamp()
+ * \param steps  Steps to take, 0 to run until the ramp stops
+ * \param time   Accumulates the simulated time (ticks)
+ *
+ * \return Period of the next step, 0 if the ramp stopped
+ */
+static uint32_t replay(StepperRamp *ramp, uint32_t period, uint32_t steps, uint64_t *time)
+{
+    uint32_t n, rate, change, last;
+
+    for (n = 0; period != 0 && (steps == 0 || n < steps) && n < MAX_STEPS; n++)
+    {
+        rate = ramp->rate;
+        last = period;
+        *time += period;
+        period = rampNextPeriod(ramp);
+        if (period == 0)
+        {
+            break;
+        }
+
+        change = (ramp->rate > rate) ? ramp->rate - rate : rate - ramp->rate;
+        if (rate < RAMP_PULL_IN_LIMIT)
+        {
+            CHECK(ramp->rate <= RAMP_PULL_IN_LIMIT, "step %u: %u -> %u steps/s leaving creep",
+                  n, rate >> RAMP_FRAC_BITS, ramp->rate >> RAMP_FRAC_BITS);
+        }
+        else if (ramp->rate > RAMP_PULL_IN_LIMIT)
+        {
+            CHECK(change <= maxRateChange(ramp->maxAccel, last),
+                  "step %u: rate changed by %u/256 steps/s over %u ticks", n, change, last);
+        }
+        if (ramp->jerk == 0)
+        {
+            CHECK(ramp->accel <= ((uint32_t)ramp->maxAccel << RAMP_FRAC_BITS), "step %u: accel %u",
+                  n, ramp->accel >> RAMP_FRAC_BITS);
+        }
+    }
+    return period;
+}
+
+/*!
+ * Accelerates to CRUISE_PERIOD, cruises, then ramps down to a stop
+ *
+ * \param jerk Jerk limit, 0 for a trapezoidal profile
+ *
+ * \return None
+ */
+static void testAccelerateAndStop(uint16_t jerk)
+{
+    StepperRamp ramp;
+    uint64_t time = 0;
+    uint32_t period;
+
+    initRamp(&ramp, RAMP_MAX_ACCEL, jerk, 1);
+    setRampTarget(&ramp, CRUISE_PERIOD);
+    period = startRamp(&ramp);
+    CHECK(period == START_PERIOD, "first period %u, expected the pull-in period", period);
+    CHECK(ramp.running, "not running after startRamp()");
+
+    period = replay(&ramp, period, 1500, &time);
+    CHECK(period >= CRUISE_PERIOD - 1 && period <= CRUISE_PERIOD + 1, "cruise period %u", period);
+
+    // Ideal trapezoid takes (1365 - 300) / 2500 s to reach cruise
+    CHECK(time > RAMP_CLK_RATE / 3 && time < RAMP_CLK_RATE * 2, "%.3f s for 1500 steps",
+          (double)time / RAMP_CLK_RATE);
+
+    setRampTarget(&ramp, 0);
+    period = replay(&ramp, period, 0, &time);
+    CHECK(period == 0, "still stepping after %u steps", MAX_STEPS);
+    CHECK(!ramp.running, "running after stopping");
+    CHECK(ramp.rate <= RAMP_PULL_IN_LIMIT, "stopped from %u steps/s", ramp.rate >> RAMP_FRAC_BITS);
+}
+
+/*!
+ * Starting before any target is set steps once at the pull-in rate
+ *
+ * \return None
+ */
+static void testStartWithoutTarget(void)
+{
+    StepperRamp ramp;
+    uint32_t period;
+
+    initRamp(&ramp, RAMP_MAX_ACCEL, RAMP_JERK, 1);
+    period = startRamp(&ramp);
+    CHECK(period == START_PERIOD, "first period %u", period);
+    CHECK(ramp.rate == RAMP_PULL_IN_LIMIT, "first rate %u/256", ramp.rate);
+    CHECK(rampNextPeriod(&ramp) == 0, "kept stepping without a target");
+}
+
+/*!
+ * Creeps at \a creepPeriod, then asks for CRUISE_PERIOD. The first step
+ *  after the creep may not go past the pull-in rate.
+ *
+ * \param creepPeriod Creep period (ticks)
+ * \param jerk        Jerk limit, 0 for a trapezoidal profile
+ *
+ * \return None
+ */
+static void testLeaveCreep(uint32_t creepPeriod, uint16_t jerk)
+{
+    StepperRamp ramp;
+    uint64_t time = 0;
+    uint32_t period;
+
+    initRamp(&ramp, RAMP_MAX_ACCEL, jerk, 1);
+    setRampTarget(&ramp, creepPeriod);
+    period = startRamp(&ramp);
+    CHECK(period == creepPeriod, "creep period %u, expected %u", period, creepPeriod);
+    period = replay(&ramp, period, 3, &time);
+    CHECK(period == creepPeriod, "creep period %u after 3 steps", period);
+
+    setRampTarget(&ramp, CRUISE_PERIOD);
+    period = replay(&ramp, period, 1, &time);
+    CHECK(period >= START_PERIOD - 1, "left creep at %u ticks per step", period);
+    period = replay(&ramp, period, 1500, &time);
+    CHECK(period >= CRUISE_PERIOD - 1 && period <= CRUISE_PERIOD + 1, "cruise period %u", period);
+}
+
+int main(void)
+{
+    testAccelerateAndStop(0);
+    testAccelerateAndStop(20000);
+    testStartWithoutTarget();
+    testLeaveCreep(1333333, 0);     // 3 steps/s
+    testLeaveCreep(40960000, 0);    // About 0.1 steps/s
+    testLeaveCreep(40960000, 20000);
+    return testResult("stepperRamp");
+}
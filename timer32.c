@@ -10,10 +10,14 @@
 #include <msp.h>
 #include <timer32.h>
 
+static ClockSnapshot gameClock;
+static SeqLock gameClockSeq;
+static int secondTicks;
+
 void setupT32()
 {
-    record = 1;
-    curTime = RESET_TIME;
+    gameClock.eighths = 0;
+    gameClock.timeLeft = RESET_TIME;
     secondTicks = 0;
 
     // Reload value = 1/8 second
@@ -27,20 +31,50 @@ void setupT32()
 
     // Set IRQ bit
     NVIC->ISER[0] |= 0x02000000;
+
+    // Timestamps: Timer32_2 enabled, free-running mode, 32-bit, prescale 1:1,
+    //  no interrupt
+    TIMER32_2->LOAD = 0xFFFFFFFF;
+    TIMER32_2->CONTROL = 0x00000082;
 }
 
 /* Timer_A1 and CCRx (except CCR0) interrupt service routine */
 void T32_INT1_IRQHandler(void)
 {
-    record = 1; // Need to update LCD and stepper speed
+    seqWriteBegin(&gameClockSeq);
+    gameClock.eighths++; // Main loop updates LCD and stepper speed once per period
     secondTicks++; // Increment ticks
     if (secondTicks == 8)
     {
         // Count down 1 second since 8 * 1/8 = 1 full second
-        curTime--;
+        gameClock.timeLeft--;
         secondTicks = 0;
     }
+    seqWriteEnd(&gameClockSeq);
 
     // Clear interrupt flag
     TIMER32_1->INTCLR = 0;
 }
+
+void readClock(ClockSnapshot *clock)
+{
+    uint32_t start;
+
+    do
+    {
+        start = seqReadBegin(&gameClockSeq);
+        *clock = gameClock;
+    } while (seqReadRetry(&gameClockSeq, start));
+}
+
+void setTimeLeft(int seconds)
+{
+    seqWriteBegin(&gameClockSeq);
+    gameClock.timeLeft = seconds;
+    seqWriteEnd(&gameClockSeq);
+}
+
+int timeLeft(void)
+{
+    return *(volatile int *)&gameClock.timeLeft;
+}
@@ -22,21 +22,27 @@ extern "C"
 #endif
 
 #include <msp.h>
+#include "seqlock.h"
 
 #define ONE_EIGHTH      (1500000*2)-1
 #define RESET_TIME      10
 #define COUNTDOWN_TIME  3
 #define GAMEPLAY_TIME   80
 
-int record;
-int secondTicks;
-int curTime;
+#define TIMESTAMP_RATE  12000000        // Timer32_2 free-running rate (MCLK), wraps after ~6 min
+
+typedef struct
+{
+    uint32_t eighths;           // 1/8 second periods since setupT32()
+    int timeLeft;               // Seconds left in the current game state
+} ClockSnapshot;
 
 /*!
  *
  * \brief This function initializes T32
  *
- * This function provides T32 with a reload value for 1/8 seconds
+ * This function provides T32 with a reload value for 1/8 seconds, and
+ * starts Timer32_2 free running as the timestamp source
  *
  * \param  None
  *
@@ -44,6 +50,52 @@ int curTime;
  */
 extern void setupT32(void);
 
+/*!
+ * \brief Copies the game clock as of one 1/8 second period
+ *
+ * Main loop only, see seqlock.h.
+ *
+ * \param clock Receives the clock
+ *
+ * \return None
+ */
+extern void readClock(ClockSnapshot *clock);
+
+/*!
+ * \brief Restarts the countdown of the game state
+ *
+ * Main loop only. The first second may be short, the phase of the 1/8
+ *  second periods is kept.
+ *
+ * \param seconds Seconds left
+ *
+ * \return None
+ */
+extern void setTimeLeft(int seconds);
+
+/*!
+ * \brief Gets the seconds left in the game state
+ *
+ * A single word, so this is also safe in interrupt handlers, which must
+ *  not use readClock().
+ *
+ * \return Seconds left
+ */
+extern int timeLeft(void);
+
+/*!
+ * \brief Reads the free-running timestamp
+ *
+ * Counts up at TIMESTAMP_RATE, so the difference of two timestamps is the
+ * time between them even across a wrap.
+ *
+ * \return Current timestamp
+ */
+static inline uint32_t readTimestamp(void)
+{
+    return ~TIMER32_2->VALUE;
+}
+
 //*****************************************************************************
 //
 // Mark the end of the C bindings section for C++ compilers.